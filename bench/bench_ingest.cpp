@@ -0,0 +1,132 @@
+/**
+ * @file bench_ingest.cpp
+ * @author <YourName>
+ * @brief Measures directory ingestion from reading the articles to the saved index
+ * @version 1.0
+ * @date 2024-03-15
+ *
+ * Usage: bench_ingest <directory> [--positions] [--memory-budget <MB>] [--output <base path>]
+ *
+ * Runs parseDirectory, the bigram build and saveIndices once, the same steps as
+ * "supersearch index", and reports throughput, peak RSS and the time of each
+ * stage. Use generate_corpus for a reproducible input, e.g.
+ *
+ *     generate_corpus /tmp/corpus 100000 42 && bench_ingest /tmp/corpus
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+#include "../include/DocumentParser.h"
+#include "../include/IndexHandler.h"
+#include "../include/StopwordSet.h"
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void printStage(const std::string& name, double seconds, double total) {
+    std::cout << "  " << std::left << std::setw(28) << name << std::right << std::fixed
+              << std::setprecision(3) << std::setw(9) << seconds << " s";
+    if (total > 0) {
+        std::cout << std::setprecision(1) << std::setw(7) << 100 * seconds / total << " %";
+    }
+    std::cout << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " <directory> [--positions] [--memory-budget <MB>] [--output <base path>]" << std::endl;
+        return 1;
+    }
+    
+    std::string directory = argv[1];
+    bool positions = false;
+    size_t memoryBudget = 0;
+    std::string output = (std::filesystem::temp_directory_path() / "bench_ingest_index").string();
+    for (int i = 2; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--positions") {
+            positions = true;
+        }
+        else if (option == "--memory-budget" && i + 1 < argc) {
+            memoryBudget = std::stoull(argv[++i]) << 20;
+        }
+        else if (option == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        }
+        else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 1;
+        }
+    }
+    
+    try {
+        StopwordSet stopwords;
+        IndexHandler index;
+        index.setStorePositions(positions);
+        index.setMemoryBudget(memoryBudget);
+        DocumentParser parser(index, stopwords);
+        
+        auto start = Clock::now();
+        parser.parseDirectory(directory);
+        double parseSeconds = secondsSince(start);
+        
+        auto bigramStart = Clock::now();
+        index.buildBigramIndex();
+        double bigramSeconds = secondsSince(bigramStart);
+        
+        auto saveStart = Clock::now();
+        index.saveIndices(output);
+        double saveSeconds = secondsSince(saveStart);
+        double totalSeconds = secondsSince(start);
+        
+        size_t indexBytes = 0;
+        for (const char* extension : {".words", ".bigrams", ".orgs", ".persons", ".meta"}) {
+            std::filesystem::path file = output + extension;
+            if (std::filesystem::exists(file)) {
+                indexBytes += std::filesystem::file_size(file);
+                std::filesystem::remove(file);
+            }
+        }
+        
+        struct rusage usage {};
+        getrusage(RUSAGE_SELF, &usage);
+        
+        const IngestStats& stats = parser.getIngestStats();
+        double megabytes = stats.bytes / double(1 << 20);
+        std::cout << "\n\nIngest benchmark: " << directory << (positions ? " (positions)" : "") << "\n"
+                  << std::fixed << std::setprecision(1)
+                  << "  documents                 " << std::setw(10) << stats.files << "\n"
+                  << "  input                     " << std::setw(10) << megabytes << " MiB\n"
+                  << "  index size                " << std::setw(10) << indexBytes / double(1 << 20) << " MiB\n"
+                  << "  throughput                " << std::setw(10) << stats.files / totalSeconds << " docs/s"
+                  << std::setw(10) << megabytes / totalSeconds << " MiB/s\n"
+                  << "  peak RSS                  " << std::setw(10) << usage.ru_maxrss / 1024.0 << " MiB\n";
+        if (memoryBudget > 0) {
+            std::cout << "  memory budget             " << std::setw(10) << (memoryBudget >> 20) << " MiB\n";
+        }
+        
+        std::cout << "Stages (wall time, % of total):\n";
+        printStage("parseDirectory", parseSeconds, totalSeconds);
+        printStage("  scan directories", stats.scanSeconds, totalSeconds);
+        printStage("  wait for analyzed articles", stats.waitSeconds, totalSeconds);
+        printStage("  add to index", stats.indexSeconds, totalSeconds);
+        printStage("buildBigramIndex", bigramSeconds, totalSeconds);
+        printStage("saveIndices", saveSeconds, totalSeconds);
+        printStage("total", totalSeconds, 0);
+        std::cout << "Parser threads (summed over threads):\n";
+        printStage("analyze articles", stats.analyzeSeconds, 0);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
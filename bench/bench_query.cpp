@@ -0,0 +1,131 @@
+/**
+ * @file bench_query.cpp
+ * @author <YourName>
+ * @brief Measures query latency against a saved index
+ * @version 1.0
+ * @date 2024-03-15
+ *
+ * Usage: bench_query <index base path> [queries file] [--repeat <n>] [--exhaustive] [--cache]
+ *
+ * Loads the index, runs every query (one per line; a built-in set of common
+ * financial terms by default) once to warm up and then n times (default 20),
+ * and reports the mean latency of each query and the overall throughput.
+ * --exhaustive scores every posting of ranked OR queries instead of pruning, and
+ * --cache serves repeated queries from a query cache (reporting its counters). Build
+ * the index from a generate_corpus corpus to compare commits, e.g.
+ *
+ *     generate_corpus /tmp/corpus 100000 42 && supersearch index /tmp/corpus /tmp/idx
+ *     bench_query /tmp/idx
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../include/IndexHandler.h"
+#include "../include/QueryProcessor.h"
+#include "../include/StopwordSet.h"
+
+using Clock = std::chrono::steady_clock;
+
+const std::vector<std::string> kDefaultQueries = {
+    "market",
+    "market stock",
+    "percent year billion",
+    "company shares investors",
+    "market stock percent year",
+    "rates inflation federal reserve",
+    "bank credit -china",
+    "trade tariffs china",
+    "oil prices demand supply",
+    "ORG:Apple shares",
+    "market OR stock OR percent",
+    "oil OR crude OR prices OR opec",
+    "bank OR rates OR inflation OR reserve OR year",
+};
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <index base path> [queries file] [--repeat <n>] [--exhaustive] [--cache]"
+                  << std::endl;
+        return 1;
+    }
+    
+    std::string base = argv[1];
+    std::vector<std::string> queries;
+    size_t repeat = 20;
+    bool pruning = true;
+    bool caching = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--repeat" && i + 1 < argc) {
+            repeat = std::max<size_t>(1, std::stoull(argv[++i]));
+        }
+        else if (option == "--exhaustive") {
+            pruning = false;
+        }
+        else if (option == "--cache") {
+            caching = true;
+        }
+        else {
+            std::ifstream file(option);
+            if (!file) {
+                std::cerr << "Cannot open queries file: " << option << std::endl;
+                return 1;
+            }
+            for (std::string line; std::getline(file, line); ) {
+                if (!line.empty()) {
+                    queries.push_back(line);
+                }
+            }
+        }
+    }
+    if (queries.empty()) {
+        queries = kDefaultQueries;
+    }
+    
+    try {
+        StopwordSet stopwords;
+        IndexHandler index;
+        index.loadIndices(base);
+        QueryProcessor processor(index, stopwords);
+        processor.setPruning(pruning);
+        QueryCache cache;
+        if (caching) {
+            processor.setCache(&cache);
+        }
+        
+        std::cout << "\nQuery benchmark: " << base << " (" << index.getTotalDocuments() << " documents, "
+                  << repeat << " runs per query)\n"
+                  << std::left << std::setw(40) << "  query" << std::right << std::setw(10) << "results"
+                  << std::setw(14) << "mean us" << "\n";
+        
+        double totalSeconds = 0;
+        for (const auto& query : queries) {
+            size_t results = processor.processQuery(query).size();
+            auto start = Clock::now();
+            for (size_t run = 0; run < repeat; ++run) {
+                processor.processQuery(query);
+            }
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            totalSeconds += seconds;
+            std::cout << "  " << std::left << std::setw(38) << query << std::right << std::setw(10) << results
+                      << std::fixed << std::setprecision(1) << std::setw(14) << 1e6 * seconds / repeat << "\n";
+        }
+        
+        std::cout << "Throughput: " << std::fixed << std::setprecision(1)
+                  << queries.size() * repeat / totalSeconds << " queries/s\n";
+        if (caching) {
+            QueryCache::Stats stats = cache.getStats();
+            std::cout << "Cache: " << stats.hits << " hits, " << stats.misses << " misses, "
+                      << stats.entries << " entries, " << stats.bytes << " bytes\n";
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,240 @@
+/**
+ * @file generate_corpus.cpp
+ * @author <YourName>
+ * @brief Writes a reproducible synthetic corpus of financial news articles
+ * @version 1.0
+ * @date 2024-03-15
+ *
+ * Usage: generate_corpus <output directory> <articles> [seed] [months]
+ *
+ * Articles are spread over month directories (2018_01, 2018_02, ...) in the
+ * layout and JSON shape of the real data set. Content words follow a Zipf
+ * distribution over a vocabulary of financial words followed by generated
+ * ones, so posting list lengths look like those of natural text: a few very
+ * long lists and a long tail of short ones. The same seed always produces the
+ * same files.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Samples ranks 0..n-1 with probability proportional to 1 / (rank + 1)^exponent
+ */
+class ZipfSampler {
+public:
+    ZipfSampler(size_t n, double exponent) : cumulative(n) {
+        double total = 0;
+        for (size_t rank = 0; rank < n; ++rank) {
+            total += 1.0 / std::pow(static_cast<double>(rank + 1), exponent);
+            cumulative[rank] = total;
+        }
+        for (double& value : cumulative) {
+            value /= total;
+        }
+    }
+    
+    template <typename Random>
+    size_t operator()(Random& random) const {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(random);
+        auto it = std::lower_bound(cumulative.begin(), cumulative.end(), u);
+        return std::min(static_cast<size_t>(it - cumulative.begin()), cumulative.size() - 1);
+    }
+
+private:
+    std::vector<double> cumulative;
+};
+
+const std::vector<std::string> kFinancialWords = {
+    "market", "stock", "shares", "company", "percent", "year", "billion", "million", "rates", "bank",
+    "investors", "growth", "quarter", "earnings", "price", "prices", "trading", "federal", "reserve",
+    "inflation", "economy", "interest", "dollar", "revenue", "profit", "sales", "china", "trade",
+    "tariffs", "oil", "bonds", "yield", "treasury", "index", "fund", "funds", "deal", "merger",
+    "acquisition", "analysts", "forecast", "debt", "credit", "jobs", "unemployment", "consumer",
+    "retail", "demand", "supply", "exports", "imports", "policy", "central", "government", "tax",
+    "crypto", "bitcoin", "currency", "euro", "yen", "emerging", "markets", "equity", "hedge",
+    "volatility", "rally", "selloff", "gains", "losses", "dividend", "buyback", "ipo", "valuation",
+    "guidance", "outlook", "recession", "output", "manufacturing", "housing", "mortgage", "lending",
+    "regulators", "regulation", "antitrust", "lawsuit", "settlement", "executive", "chief", "board",
+    "shareholders", "capital", "cash", "assets", "liabilities", "margin", "costs", "spending",
+    "budget", "deficit", "surplus", "commodities", "gold", "copper", "wheat", "energy", "technology",
+};
+
+const std::vector<std::string> kConnectives = {
+    "the", "of", "and", "to", "in", "a", "for", "on", "that", "with", "as", "by", "at", "from", "its",
+};
+
+const std::vector<std::string> kOrganizations = {
+    "Federal Reserve", "Goldman Sachs", "JPMorgan Chase", "Apple", "Amazon", "Tesla", "Microsoft",
+    "Alphabet", "Meta Platforms", "NVIDIA", "Bank of America", "Citigroup", "Morgan Stanley",
+    "European Central Bank", "Bank of Japan", "BlackRock", "Berkshire Hathaway", "ExxonMobil",
+    "Walmart", "Boeing", "General Electric", "Intel", "Netflix", "Alibaba", "Tencent", "Toyota",
+    "Volkswagen", "HSBC", "Barclays", "Deutsche Bank", "UBS", "Credit Suisse", "OPEC", "IMF",
+    "World Bank", "SEC", "Pfizer", "Johnson & Johnson", "Visa", "Mastercard",
+};
+
+const std::vector<std::string> kPersons = {
+    "Jerome Powell", "Janet Yellen", "Elon Musk", "Tim Cook", "Jeff Bezos", "Warren Buffett",
+    "Jamie Dimon", "Christine Lagarde", "Mario Draghi", "Satya Nadella", "Sundar Pichai",
+    "Mark Zuckerberg", "Jensen Huang", "Larry Fink", "Ray Dalio", "Steven Mnuchin", "Xi Jinping",
+    "Haruhiko Kuroda", "Mary Barra", "Andy Jassy",
+};
+
+const std::vector<std::string> kSources = {
+    "reuters.com", "cnbc.com", "bloomberg.com", "wsj.com", "ft.com", "marketwatch.com", "forbes.com",
+};
+
+/**
+ * @brief Pronounceable filler words for the vocabulary tail ("bravoka", "tesumi", ...)
+ */
+std::vector<std::string> makeVocabulary(size_t size, std::mt19937_64& random) {
+    static const char* syllables[] = {
+        "ba", "ke", "ri", "to", "mu", "sa", "ne", "lo", "vi", "da", "pe", "zu", "ga", "fo", "mi",
+        "ra", "te", "ko", "li", "nu", "sho", "tra", "ven", "dor", "bel", "qui", "lan", "mor",
+    };
+    constexpr size_t syllableCount = sizeof(syllables) / sizeof(syllables[0]);
+    
+    std::vector<std::string> vocabulary = kFinancialWords;
+    std::uniform_int_distribution<size_t> syllable(0, syllableCount - 1);
+    std::uniform_int_distribution<int> length(2, 4);
+    while (vocabulary.size() < size) {
+        std::string word;
+        for (int i = length(random); i > 0; --i) {
+            word += syllables[syllable(random)];
+        }
+        vocabulary.push_back(std::move(word));
+    }
+    
+    // Duplicates only make a few words slightly more frequent; keep the order
+    return vocabulary;
+}
+
+std::string makeUUID(std::mt19937_64& random) {
+    uint64_t high = random();
+    uint64_t low = random();
+    std::ostringstream out;
+    out << std::hex << std::setfill('0')
+        << std::setw(8) << (high >> 32) << '-' << std::setw(4) << ((high >> 16) & 0xFFFF) << '-'
+        << std::setw(4) << (high & 0xFFFF) << '-' << std::setw(4) << (low >> 48) << '-'
+        << std::setw(12) << (low & 0xFFFFFFFFFFFFULL);
+    return out.str();
+}
+
+/**
+ * @brief Write a JSON array of names drawn without repetition
+ */
+void writeNames(std::ostream& out, const std::vector<std::string>& names, const ZipfSampler& sampler,
+                size_t count, std::mt19937_64& random) {
+    std::vector<size_t> chosen;
+    while (chosen.size() < count) {
+        size_t index = sampler(random);
+        if (std::find(chosen.begin(), chosen.end(), index) == chosen.end()) {
+            chosen.push_back(index);
+        }
+    }
+    
+    out << '[';
+    for (size_t i = 0; i < chosen.size(); ++i) {
+        out << (i ? ", " : "") << '"' << names[chosen[i]] << '"';
+    }
+    out << ']';
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <output directory> <articles> [seed] [months]" << std::endl;
+        return 1;
+    }
+    
+    std::filesystem::path output = argv[1];
+    size_t articles = std::stoull(argv[2]);
+    uint64_t seed = argc > 3 ? std::stoull(argv[3]) : 42;
+    size_t months = argc > 4 ? std::max<size_t>(1, std::stoull(argv[4])) : 12;
+    
+    std::mt19937_64 random(seed);
+    std::vector<std::string> vocabulary = makeVocabulary(50000, random);
+    ZipfSampler wordSampler(vocabulary.size(), 1.07);
+    ZipfSampler organizationSampler(kOrganizations.size(), 1.0);
+    ZipfSampler personSampler(kPersons.size(), 1.0);
+    
+    // Article lengths are log-normal, a few hundred words with a long tail
+    std::lognormal_distribution<double> articleLength(std::log(350.0), 0.6);
+    std::uniform_int_distribution<int> sentenceLength(8, 24);
+    std::uniform_int_distribution<size_t> connective(0, kConnectives.size() - 1);
+    std::uniform_int_distribution<size_t> source(0, kSources.size() - 1);
+    std::uniform_int_distribution<int> day(1, 28), hour(0, 23), minute(0, 59);
+    std::uniform_int_distribution<size_t> organizationCount(0, 4), personCount(0, 2);
+    std::bernoulli_distribution useConnective(0.3);
+    
+    size_t bytes = 0;
+    for (size_t n = 0; n < articles; ++n) {
+        size_t month = n * months / articles;
+        std::ostringstream monthName;
+        monthName << 2018 + month / 12 << '_' << std::setw(2) << std::setfill('0') << month % 12 + 1;
+        std::filesystem::path directory = output / monthName.str();
+        if (n == 0 || (n - 1) * months / articles != month) {
+            std::filesystem::create_directories(directory);
+        }
+        
+        // Content: sentences of Zipf-distributed words with some stopword glue
+        std::string content;
+        size_t words = std::max<size_t>(20, static_cast<size_t>(articleLength(random)));
+        for (size_t written = 0; written < words; ) {
+            int length = sentenceLength(random);
+            for (int i = 0; i < length && written < words; ++i, ++written) {
+                const std::string& word = useConnective(random) ? kConnectives[connective(random)]
+                                                                : vocabulary[wordSampler(random)];
+                if (i == 0) {
+                    content += static_cast<char>(std::toupper(static_cast<unsigned char>(word[0])));
+                    content.append(word, 1);
+                }
+                else {
+                    content += ' ';
+                    content += word;
+                }
+            }
+            content += ". ";
+        }
+        content.pop_back();
+        
+        std::ostringstream title;
+        title << vocabulary[wordSampler(random)] << ' ' << vocabulary[wordSampler(random)] << ' '
+              << vocabulary[wordSampler(random)] << " report " << n;
+        
+        std::ostringstream article;
+        article << "{\"uuid\": \"" << makeUUID(random) << "\", "
+                << "\"title\": \"" << title.str() << "\", "
+                << "\"date_publish\": \"" << monthName.str().substr(0, 4) << '-' << monthName.str().substr(5)
+                << '-' << std::setw(2) << std::setfill('0') << day(random) << ' '
+                << std::setw(2) << hour(random) << ':' << std::setw(2) << minute(random) << ":00\", "
+                << "\"source\": \"" << kSources[source(random)] << "\", "
+                << "\"content\": \"" << content << "\", "
+                << "\"metadata\": {\"organizations\": ";
+        writeNames(article, kOrganizations, organizationSampler, organizationCount(random), random);
+        article << ", \"persons\": ";
+        writeNames(article, kPersons, personSampler, personCount(random), random);
+        article << "}}\n";
+        
+        std::string json = article.str();
+        std::ofstream file(directory / ("news_" + std::to_string(n) + ".json"), std::ios::binary);
+        if (!file.write(json.data(), static_cast<std::streamsize>(json.size()))) {
+            std::cerr << "Failed to write article " << n << " to " << directory << std::endl;
+            return 1;
+        }
+        bytes += json.size();
+    }
+    
+    std::cout << "Wrote " << articles << " articles (" << std::fixed << std::setprecision(1)
+              << bytes / double(1 << 20) << " MiB) in " << months << " month directories to "
+              << output.string() << " (seed " << seed << ")" << std::endl;
+    return 0;
+}
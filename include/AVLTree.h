@@ -44,7 +44,7 @@ private:
     };
     
     std::shared_ptr<Node> root;
-
+    
     // Helper methods
     int height(std::shared_ptr<Node> node) const {
         return node ? node->height : 0;
@@ -84,19 +84,23 @@ private:
         return y;
     }
     
-    std::shared_ptr<Node> insert(std::shared_ptr<Node> node, const KeyType& key, 
-                                const std::string& docID, double score) {
+    // Inserts key if missing, then calls update(node) on its node
+    template <typename Update>
+    std::shared_ptr<Node> insert(std::shared_ptr<Node> node, const KeyType& key, Update& update) {
         // Normal BST insertion
-        if (!node)
-            return std::make_shared<Node>(key, ValueType());
-            
+        if (!node) {
+            auto created = std::make_shared<Node>(key, ValueType());
+            update(*created);
+            return created;
+        }
+        
         if (key < node->key)
-            node->left = insert(node->left, key, docID, score);
+            node->left = insert(node->left, key, update);
         else if (key > node->key)
-            node->right = insert(node->right, key, docID, score);
+            node->right = insert(node->right, key, update);
         else {
-            // Key exists, update document scores
-            node->docScores[docID] = score;
+            // Key exists, update in place
+            update(*node);
             return node; // No structural change
         }
         
@@ -109,11 +113,11 @@ private:
         // Left Left Case
         if (balance > 1 && key < node->left->key)
             return rotateRight(node);
-            
+        
         // Right Right Case
         if (balance < -1 && key > node->right->key)
             return rotateLeft(node);
-            
+        
         // Left Right Case
         if (balance > 1 && key > node->left->key) {
             node->left = rotateLeft(node->left);
@@ -129,10 +133,25 @@ private:
         return node;
     }
     
+    // Iterative lookup without shared_ptr copies; K may be any type comparable with KeyType
+    template <typename K>
+    Node* findNode(const K& key) const {
+        Node* node = root.get();
+        while (node) {
+            if (key < node->key)
+                node = node->left.get();
+            else if (node->key < key)
+                node = node->right.get();
+            else
+                return node;
+        }
+        return nullptr;
+    }
+    
     std::shared_ptr<Node> search(std::shared_ptr<Node> node, const KeyType& key) const {
         if (!node || node->key == key)
             return node;
-            
+        
         if (key < node->key)
             return search(node->left, key);
         else
@@ -169,6 +188,51 @@ private:
         if (hasRight) serializeHelper(out, node->right);
     }
     
+    template <typename WriteValue>
+    void serializeValues(std::ofstream& out, const Node* node, WriteValue& writeValue) const {
+        size_t keySize = node->key.size();
+        out.write(reinterpret_cast<const char*>(&keySize), sizeof(keySize));
+        out.write(node->key.c_str(), keySize);
+        
+        writeValue(out, node->value);
+        
+        bool hasLeft = node->left != nullptr;
+        bool hasRight = node->right != nullptr;
+        
+        out.write(reinterpret_cast<const char*>(&hasLeft), sizeof(hasLeft));
+        if (hasLeft) serializeValues(out, node->left.get(), writeValue);
+        
+        out.write(reinterpret_cast<const char*>(&hasRight), sizeof(hasRight));
+        if (hasRight) serializeValues(out, node->right.get(), writeValue);
+    }
+    
+    template <typename ReadValue>
+    std::shared_ptr<Node> deserializeValues(std::ifstream& in, ReadValue& readValue) {
+        size_t keySize;
+        in.read(reinterpret_cast<char*>(&keySize), sizeof(keySize));
+        if (!in) {
+            throw std::runtime_error("Truncated index file");
+        }
+        
+        std::string key(keySize, ' ');
+        in.read(&key[0], keySize);
+        
+        auto node = std::make_shared<Node>(key, ValueType());
+        readValue(in, node->value);
+        
+        bool hasLeft, hasRight;
+        
+        in.read(reinterpret_cast<char*>(&hasLeft), sizeof(hasLeft));
+        if (hasLeft) node->left = deserializeValues(in, readValue);
+        
+        in.read(reinterpret_cast<char*>(&hasRight), sizeof(hasRight));
+        if (hasRight) node->right = deserializeValues(in, readValue);
+        
+        node->height = 1 + std::max(height(node->left), height(node->right));
+        
+        return node;
+    }
+    
     std::shared_ptr<Node> deserializeHelper(std::ifstream& in) {
         // Read key
         size_t keySize;
@@ -220,6 +284,15 @@ private:
         traverseInOrder(node->right, func);
     }
     
+    template <typename Func>
+    static void traverseValuesInOrder(Node* node, Func& func) {
+        if (!node) return;
+        
+        traverseValuesInOrder(node->left.get(), func);
+        func(node->key, node->value);
+        traverseValuesInOrder(node->right.get(), func);
+    }
+
 public:
     AVLTree() : root(nullptr) {}
     
@@ -230,7 +303,52 @@ public:
      * @param score TF-IDF score or initial term frequency
      */
     void insert(const KeyType& key, const std::string& docID, double score) {
-        root = insert(root, key, docID, score);
+        auto update = [&](Node& node) { node.docScores[docID] = score; };
+        root = insert(root, key, update);
+    }
+    
+    /**
+     * @brief Get the value stored under key, inserting a default value if missing
+     * @param key Word or entity
+     * @return Reference to the value, valid until the key is removed
+     */
+    ValueType& getOrInsert(const KeyType& key) {
+        ValueType* value = nullptr;
+        auto update = [&](Node& node) { value = &node.value; };
+        root = insert(root, key, update);
+        return *value;
+    }
+    
+    /**
+     * @brief Find the value stored under key
+     * @param key Word or entity (any type comparable with KeyType)
+     * @return Pointer to the value, or nullptr if key is absent
+     */
+    template <typename K>
+    const ValueType* find(const K& key) const {
+        Node* node = findNode(key);
+        return node ? &node->value : nullptr;
+    }
+    
+    /**
+     * @brief Find the smallest key not below a given one
+     * @param key Lower bound (any type comparable with KeyType)
+     * @return Pointer to the key, or nullptr if every key is smaller
+     */
+    template <typename K>
+    const KeyType* lowerBound(const K& key) const {
+        const KeyType* bound = nullptr;
+        Node* node = root.get();
+        while (node) {
+            if (node->key < key) {
+                node = node->right.get();
+            }
+            else {
+                bound = &node->key;
+                node = node->left.get();
+            }
+        }
+        return bound;
     }
     
     /**
@@ -286,6 +404,62 @@ public:
         traverseInOrder(root, func);
     }
     
+    /**
+     * @brief Serializes keys and values to a binary file
+     * @param filename Path to output file
+     * @param writeValue Called as writeValue(std::ofstream&, const ValueType&)
+     */
+    template <typename WriteValue>
+    void serialize(const std::string& filename, WriteValue writeValue) const {
+        std::ofstream out(filename, std::ios::binary);
+        if (!out) {
+            throw std::runtime_error("Failed to open file for writing: " + filename);
+        }
+        
+        bool hasRoot = root != nullptr;
+        out.write(reinterpret_cast<const char*>(&hasRoot), sizeof(hasRoot));
+        if (hasRoot) serializeValues(out, root.get(), writeValue);
+    }
+    
+    /**
+     * @brief Deserializes keys and values written by serialize(filename, writeValue)
+     * @param filename Path to input file
+     * @param readValue Called as readValue(std::ifstream&, ValueType&)
+     */
+    template <typename ReadValue>
+    void deserialize(const std::string& filename, ReadValue readValue) {
+        std::ifstream in(filename, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Failed to open file for reading: " + filename);
+        }
+        
+        bool hasRoot = false;
+        in.read(reinterpret_cast<char*>(&hasRoot), sizeof(hasRoot));
+        root = hasRoot ? deserializeValues(in, readValue) : nullptr;
+    }
+    
+    /**
+     * @brief Traverse the tree in key order and apply function to each key and value
+     * @param func Called as func(const KeyType&, ValueType&)
+     */
+    template <typename Func>
+    void traverseValues(Func func) {
+        traverseValuesInOrder(root.get(), func);
+    }
+    
+    template <typename Func>
+    void traverseValues(Func func) const {
+        auto constFunc = [&](const KeyType& key, const ValueType& value) { func(key, value); };
+        traverseValuesInOrder(root.get(), constFunc);
+    }
+    
+    /**
+     * @brief Remove all keys
+     */
+    void clear() {
+        root = nullptr;
+    }
+    
     /**
      * @brief Check if tree is empty
      * @return true if empty, false otherwise
@@ -15,59 +15,166 @@
 
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_set>
 #include <fstream>
+#include <memory>
+#include <utility>
+#include "FileReader.h"
 #include "IndexHandler.h"
-#include "../thirdparty/rapidjson/include/rapidjson/document.h"
+#include "Manifest.h"
+#include "StopwordSet.h"
+
+/**
+ * @brief Where the time of a directory ingestion went
+ *
+ * Reading and analysis run on other threads and overlap with indexing, so the
+ * stages do not add up to the wall time. waitSeconds is how long indexing sat
+ * idle waiting for the next analyzed article (reading or analysis was the
+ * bottleneck); analyzeSeconds is summed over all parser threads.
+ */
+struct IngestStats {
+    size_t files = 0;           // articles indexed
+    size_t bytes = 0;           // article JSON read
+    double scanSeconds = 0;     // listing the directory tree
+    double analyzeSeconds = 0;  // parsing JSON and analyzing text, all threads
+    double waitSeconds = 0;     // indexing thread waiting for analyzed articles
+    double indexSeconds = 0;    // adding analyzed articles to the index
+};
 
 class DocumentParser {
 private:
+    /**
+     * @brief One article after parsing and text analysis, ready to be indexed
+     */
+    struct AnalyzedArticle {
+        std::string uuid;
+        std::string title;
+        int64_t published = 0;                                // see DocumentStore::parseDate
+        std::string source;
+        bool hasContent = false;
+        bool alreadyIndexed = false;
+        uint32_t length = 0;                                  // indexed token count
+        std::vector<std::pair<std::string, uint32_t>> terms;  // stemmed term, frequency
+        bool hasPositions = false;
+        std::vector<uint32_t> positions;                      // each term's positions, in terms order
+        std::vector<std::pair<uint32_t, uint32_t>> bigrams;   // adjacent term pairs (indexes into terms)
+        uint64_t fingerprint = 0;                             // SimHash of the content, 0 if not computed
+        std::vector<std::string> organizations;
+        std::vector<std::string> persons;
+    };
+    
     IndexHandler& indexHandler;
-    std::unordered_set<std::string> stopwords;
+    const StopwordSet& stopwords;
+    std::unique_ptr<FileReader> fileReader;
+    AnalyzedArticle articleScratch;  // reused by the single-threaded readers
+    IngestStats ingestStats;         // of the last parseDirectory call
     
     /**
-     * @brief Process article content with stemming and stopword removal
-     * @param content Article text
-     * @param docID Article UUID
+     * @brief Tokenize, drop stopwords, stem and count the terms of an article
+     * @param content Article text (view into the parse buffer)
+     * @param article Receives the term frequencies and length, the token
+     *                positions when the index stores them, and the SimHash of
+     *                the content when the index detects near-duplicates
      */
-    void processContent(const std::string& content, const std::string& docID);
+    void processContent(std::string_view content, AnalyzedArticle& article) const;
     
     /**
-     * @brief Extract entities from article metadata
-     * @param metadata JSON metadata object
-     * @param docID Article UUID
+     * @brief Parse an article and analyze its text without touching the index
+     * 
+     * Safe to call from several threads at once when checkIndexed is false.
+     * 
+     * @param json NUL-terminated article JSON; parsed in place, so it is modified
+     * @param article Receives the extracted fields and terms
+     * @param checkIndexed Stop early (setting alreadyIndexed) if the uuid is indexed
      */
-    void processEntities(const rapidjson::Value& metadata, const std::string& docID);
+    void analyzeArticle(char* json, AnalyzedArticle& article, bool checkIndexed) const;
     
     /**
-     * @brief Load stopwords from file
-     * @param filename Path to stopwords file
+     * @brief Add an analyzed article to the index
+     *
+     * Skipped if already indexed; collapsed into the earlier document if its
+     * SimHash marks it as a near-duplicate of one.
+     *
+     * @param article Result of analyzeArticle
+     * @return Ordinal the article is indexed under (an existing one if skipped or collapsed)
      */
-    void loadStopwords(const std::string& filename);
+    uint32_t indexArticle(const AnalyzedArticle& article);
     
+    /**
+     * @brief Parse and index one article
+     * @param json NUL-terminated article JSON; parsed in place, so it is modified
+     */
+    void parseArticle(char* json);
+
 public:
     /**
      * @brief Constructor
      * @param handler Reference to index handler
-     * @param stopwordsFile Path to stopwords file
+     * @param stopwords Stopwords to drop from content
      */
-    DocumentParser(IndexHandler& handler, const std::string& stopwordsFile);
+    DocumentParser(IndexHandler& handler, const StopwordSet& stopwords);
     
     /**
      * @brief Parse a JSON news article
+     * 
+     * The file is read into a per-thread buffer that is reused across calls and
+     * parsed in place with a SAX handler that keeps only the indexed fields, so
+     * field values are views into that buffer rather than copies.
+     * 
      * @param filename Path to JSON file
      */
     void parseJSON(const std::string& filename);
     
     /**
      * @brief Parse a directory of JSON files
+     * 
+     * Files are read by the batched FileReader (io_uring where available) and
+     * parsed on worker threads; the results are added to the index on the calling
+     * thread in directory order, so document ordinals do not depend on timing.
+     * 
+     * With a manifest only new and changed files are parsed: the documents of
+     * changed and removed files are tombstoned first, and the manifest is updated
+     * with every file indexed.
+     * 
      * @param directory Path to directory
+     * @param manifest Files indexed by the previous run over this directory, or nullptr
+     */
+    void parseDirectory(const std::string& directory, Manifest* manifest = nullptr);
+    
+    /**
+     * @brief Stage timings and volume of the last parseDirectory call
+     */
+    const IngestStats& getIngestStats() const { return ingestStats; }
+    
+    /**
+     * @brief Parse a JSON-lines file (one article per line)
+     * 
+     * The file is read sequentially in large chunks and each line is parsed in
+     * place inside the chunk buffer.
+     * 
+     * @param filename Path to .jsonl file
+     */
+    void parseJSONLines(const std::string& filename);
+    
+    /**
+     * @brief Parse the .json entries of an uncompressed tar archive
+     * 
+     * The archive is streamed front to back; each entry is read into the reused
+     * article buffer, so no per-file handles or objects are created.
+     * 
+     * @param filename Path to .tar file
      */
-    void parseDirectory(const std::string& directory);
+    void parseTar(const std::string& filename);
     
     /**
-     * @brief Calculate TF-IDF scores for indexed documents
+     * @brief Parse a directory, .jsonl file, .tar archive or single JSON file
+     * 
+     * Afterwards the frequent-bigram index is rebuilt to cover the new documents,
+     * and the number of near-duplicates collapsed is reported if detection is on.
+     * 
+     * @param path Input path; the kind is chosen from the path itself
+     * @param manifest Manifest for incremental directory indexing, or nullptr
      */
-    void calculateTFIDF();
+    void parsePath(const std::string& path, Manifest* manifest = nullptr);
 };
\ No newline at end of file
@@ -0,0 +1,142 @@
+/**
+ * @file DocumentStore.h
+ * @author <YourName>
+ * @brief Typed per-document display metadata (title, source, publication date)
+ * @version 1.0
+ * @date 2024-03-15
+ *
+ * History:
+ * - 2024-03-15: Initial implementation
+ */
+
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Metadata of one document as stored: offsets and IDs, no strings
+ */
+struct DocumentInfo {
+    uint64_t titleOffset = 0;  // into the title pool
+    uint32_t titleLength = 0;
+    uint32_t source = 0;       // interned source ID (0 is the empty source)
+    int64_t published = 0;     // seconds since the Unix epoch (UTC), or DocumentStore::kUnknownDate
+};
+
+/**
+ * @brief Metadata of one document, viewing the store's strings
+ *
+ * The views stay valid until the next call to set, read or clear.
+ */
+struct DocumentView {
+    std::string_view title;
+    std::string_view source;
+    int64_t published;
+};
+
+/**
+ * @brief Ordinal-indexed array of DocumentInfo with pooled strings
+ *
+ * Titles are appended to one contiguous pool and sources, of which a corpus
+ * has only a few hundred, are interned. Dates are parsed once when a document
+ * is added, so reading a document's metadata at query time is an array lookup
+ * that copies nothing.
+ */
+class DocumentStore {
+public:
+    static constexpr int64_t kUnknownDate = std::numeric_limits<int64_t>::min();
+    
+    /**
+     * @brief Parse a publication date
+     *
+     * Accepts "YYYY-MM-DD", optionally followed by 'T' or a space and
+     * "HH:MM[:SS[.fraction]]" and a "Z" or "+HH:MM"/"-HH:MM" offset, which is
+     * applied so that the result is UTC.
+     *
+     * @param date Date as found in the article
+     * @return Seconds since the Unix epoch, or kUnknownDate if it is not a valid date
+     */
+    static int64_t parseDate(std::string_view date);
+    
+    /**
+     * @brief Format a parsed date for display
+     * @param published Seconds since the Unix epoch, or kUnknownDate
+     * @return "YYYY-MM-DD HH:MM:SS" (UTC), or "Unknown Date"
+     */
+    static std::string formatDate(int64_t published);
+    
+    /**
+     * @brief Append an empty entry for the next ordinal
+     */
+    void add() { documents.emplace_back(); }
+    
+    /**
+     * @brief Set the metadata of a document
+     * @param doc Document ordinal, already added
+     * @param title Article title
+     * @param published Parsed publication date (see parseDate)
+     * @param source Publication source
+     */
+    void set(uint32_t doc, std::string_view title, int64_t published, std::string_view source);
+    
+    /**
+     * @brief Reset a document to the empty entry
+     *
+     * Its title stays in the pool until the store is rebuilt.
+     */
+    void erase(uint32_t doc) { documents[doc] = DocumentInfo(); }
+    
+    /**
+     * @brief Metadata of a document
+     * @param doc Document ordinal
+     * @return Views into the store, or an empty view for an unknown ordinal
+     */
+    DocumentView get(uint32_t doc) const;
+    
+    /**
+     * @brief Stored entry of a document (offsets and IDs)
+     */
+    const DocumentInfo& info(uint32_t doc) const { return documents[doc]; }
+    
+    /**
+     * @brief Number of entries (one per registered ordinal)
+     */
+    size_t size() const { return documents.size(); }
+    
+    /**
+     * @brief Remove every entry, title and source
+     */
+    void clear();
+    
+    /**
+     * @brief Write the entries, title pool and sources
+     */
+    void write(std::ofstream& out) const;
+    
+    /**
+     * @brief Replace the contents with saved ones
+     */
+    void read(std::ifstream& in);
+
+private:
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+    
+    /**
+     * @brief ID of a source name, assigning the next ID if it is new
+     */
+    uint32_t internSource(std::string_view source);
+    
+    std::vector<DocumentInfo> documents;  // ordinal -> metadata
+    std::string titles;                   // every title, back to back
+    std::vector<std::string> sources{""}; // source ID -> name
+    std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> sourceIDs{{"", 0}};
+};
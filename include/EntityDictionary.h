@@ -0,0 +1,115 @@
+/**
+ * @file EntityDictionary.h
+ * @author <YourName>
+ * @brief Normalized, interned organization and person names
+ * @version 1.0
+ * @date 2024-03-15
+ *
+ * History:
+ * - 2024-03-15: Initial implementation
+ */
+
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Maps entity names to dense IDs
+ *
+ * Names are normalized before lookup: letters are case folded as the tokenizer
+ * folds them ("SOCIÉTÉ" and "société" match), and runs of whitespace (or
+ * underscores, so single query tokens can name multi-word entities) collapse
+ * to one space, with no leading or trailing space. An alias
+ * table then maps alternative names onto a canonical one, so "Alphabet Inc" and
+ * "Google" can share an ID. IDs are assigned in first-seen order and index
+ * per-entity posting vectors directly.
+ */
+class EntityDictionary {
+public:
+    static constexpr uint32_t kUnknown = UINT32_MAX;
+    
+    /**
+     * @brief Normalize an entity name
+     * @param name Raw name from article metadata or a query
+     * @return Case-folded, whitespace-collapsed name
+     */
+    static std::string normalize(std::string_view name);
+    
+    /**
+     * @brief Make alias resolve to canonical
+     * @param alias Alternative name
+     * @param canonical Name whose ID the alias shares
+     */
+    void addAlias(std::string_view alias, std::string_view canonical);
+    
+    /**
+     * @brief Load aliases from a file of "alias<TAB>canonical" lines
+     *
+     * Blank lines and lines starting with '#' are ignored. Aliases should be
+     * loaded before indexing, since names interned earlier keep their own IDs.
+     *
+     * @param filename Alias file
+     * @return false if the file could not be opened
+     */
+    bool loadAliases(const std::string& filename);
+    
+    /**
+     * @brief Get the ID of a name, assigning the next ID if it is new
+     * @param name Raw entity name
+     * @return Entity ID
+     */
+    uint32_t intern(std::string_view name);
+    
+    /**
+     * @brief Get the ID of a name without adding it
+     * @param name Raw entity name
+     * @return Entity ID, or kUnknown
+     */
+    uint32_t lookup(std::string_view name) const;
+    
+    /**
+     * @brief Canonical normalized name of an ID
+     */
+    const std::string& name(uint32_t id) const { return names[id]; }
+    
+    /**
+     * @brief Number of distinct entities
+     */
+    size_t size() const { return names.size(); }
+    
+    /**
+     * @brief Write names and aliases
+     */
+    void write(std::ofstream& out) const;
+    
+    /**
+     * @brief Replace the names with saved ones and merge the saved aliases
+     *
+     * Aliases already present (e.g. loaded from the command line) take
+     * precedence over saved aliases with the same name.
+     */
+    void read(std::ifstream& in);
+
+private:
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+    
+    using NameMap = std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>>;
+    using AliasMap = std::unordered_map<std::string, std::string, StringHash, std::equal_to<>>;
+    
+    /**
+     * @brief Follow the alias table from a normalized name
+     */
+    std::string_view resolve(std::string_view normalized) const;
+    
+    std::vector<std::string> names;  // ID -> canonical name
+    NameMap ids;                     // canonical name -> ID
+    AliasMap aliases;                // normalized alias -> normalized canonical
+};
@@ -4,33 +4,308 @@
  * @brief Manages AVL tree indices for words and entities
  * @version 1.0
  * @date 2024-03-15
- * 
+ *
  * History:
  * - 2024-03-15: Initial implementation
  */
 
 #pragma once
 #include "AVLTree.h"
-#include <unordered_set>
+#include "DocumentStore.h"
+#include "EntityDictionary.h"
+#include "PostingList.h"
+#include "SimHash.h"
+#include "TermTrie.h"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
-#include "../thirdparty/rapidjson/include/rapidjson/document.h"
 
+/**
+ * @brief Inverted indices plus the collection statistics needed to score them
+ *
+ * Postings store raw term frequencies only. Document frequencies (posting list
+ * lengths), document lengths and the total length are maintained as documents
+ * are added, so scores are computed at query time and adding documents never
+ * requires rescoring the existing index.
+ *
+ * With a memory budget set, indexing is single-pass in-memory inversion (SPIMI):
+ * once the word postings added since the last spill exceed the budget, the word
+ * index is written in term order to a run file and cleared. saveIndices merges
+ * the runs into the final word index file. While runs exist the in-memory word
+ * index holds only the documents added since the last spill, so it is meant for
+ * batch indexing followed by a single save; load the saved index to query it.
+ */
 class IndexHandler {
 private:
-    AVLTree<std::string, std::string> wordIndex;
-    AVLTree<std::string, std::string> organizationIndex;
-    AVLTree<std::string, std::string> personIndex;
-    std::unordered_set<std::string> documentIDs;
-    std::unordered_map<std::string, std::string> documentMetadata; // uuid -> title, date, etc.
+    AVLTree<std::string, PostingList> wordIndex;
+    EntityDictionary organizationNames;
+    EntityDictionary personNames;
+    std::vector<PostingList> organizationPostings;          // organization ID -> postings
+    std::vector<PostingList> personPostings;                // person ID -> postings
+    std::vector<std::string> documentIDs;                   // ordinal -> uuid
+    std::unordered_map<std::string, uint32_t> documentOrdinals; // uuid -> ordinal
+    DocumentStore documentInfo;                             // ordinal -> title, date, source
+    std::vector<uint32_t> documentLengths;                  // ordinal -> indexed token count
+    uint64_t totalDocumentLength = 0;                       // over documents not deleted
+    std::vector<bool> deletedDocuments;                     // ordinal -> tombstoned by deleteDocuments
+    size_t deletedCount = 0;
+    size_t duplicateCount = 0;                              // IDs collapsed into another document
+    bool storePositions = false;                            // word postings carry positions
+    bool detectDuplicates = false;                          // collapse near-duplicate articles
+    SimHashIndex nearDuplicates;                            // fingerprints of indexed documents
+    uint64_t generation = 0;                                // bumped by every mutation
+    TermTrie wordTrie;                                      // words of wordIndex, for fuzzy lookup
+    uint64_t wordTrieGeneration = UINT64_MAX;               // generation wordTrie was built at
+    
+    // Frequent-bigram index: adjacent word pairs stored as pseudo-terms "first second"
+    AVLTree<std::string, PostingList> bigramIndex;
+    std::unordered_map<std::string, uint64_t> bigramCounts; // approximate counts of candidate pairs
+    uint64_t bigramCountFloor = 0;                          // largest count pruned from bigramCounts
+    size_t bigramLimit = 1000;                              // number of bigrams to index
+    bool bigramsCurrent = true;                             // bigramIndex reflects every document
+    
+    // Memory-bounded construction: word postings spill to sorted run files
+    size_t memoryBudget = 0;                                // word posting bytes before a spill (0 = unlimited)
+    size_t wordIndexBytes = 0;                              // estimated bytes added since the last spill
+    std::filesystem::path runDirectory;                     // temporary directory holding the runs
+    std::vector<std::string> runFiles;                      // spilled runs, oldest first
+    
+    /**
+     * @brief Supplies a word's postings during bigram construction
+     *
+     * Returns the postings of term, or nullptr if it is not indexed. Lists that
+     * are not held in memory are read into storage and a pointer to it returned.
+     */
+    using WordSource = std::function<const PostingList*(const std::string& term, PostingList& storage)>;
+    
+    /**
+     * @brief The most frequent counted or previously indexed pairs, as (frequency, key)
+     */
+    std::vector<std::pair<uint64_t, std::string>> bigramCandidates() const;
+    
+    /**
+     * @brief Replace the bigram index with the top candidates found in the word postings
+     */
+    void buildBigramIndex(const std::vector<std::pair<uint64_t, std::string>>& candidates,
+                          const WordSource& words);
+    
+    /**
+     * @brief Account for memory added to a word's posting list
+     * @param term Term the list belongs to
+     * @param before The list's memoryUsage() before the addition
+     * @param after The list's memoryUsage() after the addition
+     */
+    void trackWordMemory(const std::string& term, size_t before, size_t after);
+    
+    /**
+     * @brief Write the in-memory word index to a new run file and clear it
+     */
+    void spillRun();
+    
+    /**
+     * @brief K-way merge the runs into the word index file and build the bigram index
+     * @param filename Destination, in the format of AVLTree::serialize
+     */
+    void mergeRuns(const std::string& filename);
     
+    /**
+     * @brief Delete the run files and their directory
+     */
+    void removeRuns();
+    
+    /**
+     * @brief Drop the least frequent candidates once bigramCounts outgrows its budget
+     */
+    void pruneBigramCounts();
+    
+    /**
+     * @brief Add the posting for an entity ID, growing the posting vector for new IDs
+     */
+    static void addEntity(std::vector<PostingList>& postings, uint32_t id, uint32_t doc);
+    
+    /**
+     * @brief Save or load one entity dictionary together with its postings
+     */
+    static void saveEntities(const std::string& filename, const EntityDictionary& names,
+                             const std::vector<PostingList>& postings);
+    static void loadEntities(const std::string& filename, EntityDictionary& names,
+                             std::vector<PostingList>& postings);
+
 public:
+    static constexpr uint32_t kNoDocument = UINT32_MAX;
+    
     IndexHandler() = default;
+    ~IndexHandler();
+    
+    IndexHandler(const IndexHandler&) = delete;
+    IndexHandler& operator=(const IndexHandler&) = delete;
+    
+    /**
+     * @brief Version of the index contents
+     *
+     * Every method that changes what a query could return increments it, so a
+     * result computed at one generation is valid as long as it is unchanged.
+     */
+    uint64_t getGeneration() const { return generation; }
+    
+    /**
+     * @brief Load entity aliases used by both the organization and person indexes
+     * @param filename File of "alias<TAB>canonical" lines
+     * @return false if the file could not be opened
+     */
+    bool loadAliases(const std::string& filename);
+    
+    /**
+     * @brief Choose whether word postings record token positions (for phrase queries)
+     * @param enabled true to record positions for documents added from now on
+     */
+    void setStorePositions(bool enabled) { storePositions = enabled; }
+    
+    /**
+     * @brief Whether word postings record token positions
+     */
+    bool storesPositions() const { return storePositions; }
+    
+    /**
+     * @brief Choose whether near-duplicate articles are collapsed at ingest
+     * @param enabled true to fingerprint documents added from now on
+     */
+    void setDetectDuplicates(bool enabled) { detectDuplicates = enabled; }
+    
+    /**
+     * @brief Whether documents should be fingerprinted and checked for near-duplicates
+     */
+    bool detectsDuplicates() const { return detectDuplicates; }
+    
+    /**
+     * @brief Find an indexed document whose SimHash is within a few bits of fingerprint
+     * @param fingerprint SimHash of a new document
+     * @return Ordinal of the earliest such document, or SimHashIndex::kNotFound
+     */
+    uint32_t findNearDuplicate(uint64_t fingerprint) const { return nearDuplicates.find(fingerprint); }
+    
+    /**
+     * @brief Record the SimHash of an indexed document
+     * @param doc Document ordinal
+     * @param fingerprint SimHash of its content
+     */
+    void setDocumentFingerprint(uint32_t doc, uint64_t fingerprint) { nearDuplicates.insert(doc, fingerprint); }
+    
+    /**
+     * @brief Collapse a document into an indexed near-duplicate
+     *
+     * The ID is registered as another name of the canonical document, so it
+     * counts as indexed but adds no postings, metadata or ordinal.
+     *
+     * @param docID ID of the duplicate
+     * @param canonical Ordinal of the document it duplicates
+     */
+    void addDuplicate(const std::string& docID, uint32_t canonical);
+    
+    /**
+     * @brief Number of document IDs collapsed into another document
+     */
+    size_t getDuplicateCount() const { return duplicateCount; }
+    
+    /**
+     * @brief Tombstone documents, e.g. because their files were removed or changed
+     *
+     * Their postings stay in the index until the next full rebuild, but queries
+     * skip them and they no longer count toward the collection statistics. Their
+     * IDs, including those of duplicates collapsed into them, become unindexed,
+     * so a changed article can be added again under the same ID.
+     *
+     * @param docs Document ordinals; already deleted ones are ignored
+     */
+    void deleteDocuments(const std::vector<uint32_t>& docs);
+    
+    /**
+     * @brief Whether a document has been tombstoned
+     */
+    bool isDeleted(uint32_t doc) const { return doc < deletedDocuments.size() && deletedDocuments[doc]; }
+    
+    /**
+     * @brief Number of tombstoned documents
+     */
+    size_t getDeletedCount() const { return deletedCount; }
+    
+    /**
+     * @brief Limit the memory held by word postings while indexing
+     *
+     * Word postings beyond the budget are spilled to run files in the system
+     * temporary directory and merged by saveIndices. Entities, document metadata
+     * and indexes loaded from disk are not counted.
+     *
+     * @param bytes Budget in bytes, or 0 to keep the whole index in memory
+     */
+    void setMemoryBudget(size_t bytes) { memoryBudget = bytes; }
+    
+    /**
+     * @brief Number of runs spilled and not yet merged
+     */
+    size_t getRunCount() const { return runFiles.size(); }
+    
+    /**
+     * @brief Set how many of the most frequent bigrams are indexed (0 disables the bigram index)
+     */
+    void setBigramLimit(size_t limit) { bigramLimit = limit; }
+    
+    /**
+     * @brief Whether documents should report their adjacent term pairs
+     */
+    bool collectsBigrams() const { return storePositions && bigramLimit > 0; }
+    
+    /**
+     * @brief Count occurrences of an adjacent term pair toward bigram selection
+     * @param first Stemmed term
+     * @param second Stemmed term at the next token position
+     * @param count Occurrences in the document
+     */
+    void countBigram(const std::string& first, const std::string& second, uint32_t count);
+    
+    /**
+     * @brief Rebuild the bigram index from the word postings
+     *
+     * Picks the most frequent counted pairs and derives their postings (with the
+     * position of the first word) from the positional postings of both words.
+     * Does nothing if no documents were added since the last build. While runs
+     * exist the build is left to saveIndices, which sees the merged postings.
+     */
+    void buildBigramIndex();
+    
+    /**
+     * @brief Look up the postings of an adjacent term pair
+     * @param first Stemmed term
+     * @param second Stemmed term directly following it
+     * @return Positional posting list, or nullptr if the pair is not indexed or
+     *         the bigram index is out of date
+     */
+    const PostingList* getBigramPostings(const std::string& first, const std::string& second) const;
+    
+    /**
+     * @brief Summarize the word postings in blocks for ranked OR queries
+     *
+     * Only postings added since the last call are summarized. Called after
+     * indexing and loading; while runs exist the in-memory lists are partial
+     * and are left alone.
+     */
+    void buildScoreBounds();
+    
+    /**
+     * @brief Rebuild the trie of indexed words used by findSimilarWords
+     *
+     * Called after indexing and loading. Any later change to the index makes
+     * findSimilarWords fall back to walking the word index until the next call.
+     */
+    void buildWordTrie();
     
     /**
      * @brief Get total number of indexed documents
-     * @return Document count
+     * @return Document count, not including deleted documents
      */
     size_t getTotalDocuments() const;
     
@@ -41,50 +316,90 @@ public:
      */
     size_t getDocumentFrequency(const std::string& term) const;
     
+    /**
+     * @brief Get number of indexed tokens in a document
+     * @param doc Document ordinal
+     * @return Document length
+     */
+    uint32_t getDocumentLength(uint32_t doc) const { return documentLengths[doc]; }
+    
+    /**
+     * @brief Get mean document length over the collection
+     * @return Average indexed tokens per live document (at least 1)
+     */
+    double getAverageDocumentLength() const;
+    
+    /**
+     * @brief Get the UUID of a document
+     * @param doc Document ordinal
+     * @return Document ID
+     */
+    const std::string& getDocumentID(uint32_t doc) const { return documentIDs[doc]; }
+    
     /**
      * @brief Add term to word index
      * @param term Stemmed word
-     * @param docID Document ID
-     * @param score Initial term frequency
+     * @param doc Document ordinal
+     * @param tf Occurrences of term in the document
+     */
+    void addTerm(const std::string& term, uint32_t doc, uint32_t tf = 1);
+    
+    /**
+     * @brief Add term with its token positions to word index
+     * @param term Stemmed word
+     * @param doc Document ordinal
+     * @param positions Ascending token positions of the term in the document
+     * @param count Number of positions (the term frequency)
      */
-    void addTerm(const std::string& term, const std::string& docID, double score = 1.0);
+    void addTermPositions(const std::string& term, uint32_t doc, const uint32_t* positions, uint32_t count);
     
     /**
      * @brief Add organization entity
-     * @param org Organization name
-     * @param docID Document ID
+     * @param org Organization name (normalized and alias-resolved here)
+     * @param doc Document ordinal
      */
-    void addOrganization(const std::string& org, const std::string& docID);
+    void addOrganization(std::string_view org, uint32_t doc);
     
     /**
      * @brief Add person entity
-     * @param person Person name
-     * @param docID Document ID
+     * @param person Person name (normalized and alias-resolved here)
+     * @param doc Document ordinal
      */
-    void addPerson(const std::string& person, const std::string& docID);
+    void addPerson(std::string_view person, uint32_t doc);
     
     /**
      * @brief Add document metadata
-     * @param docID Document ID
+     * @param doc Document ordinal
      * @param title Article title
-     * @param date Publication date
+     * @param published Publication date from DocumentStore::parseDate
      * @param source Publication source
      */
-    void addDocumentMetadata(const std::string& docID, const std::string& title, 
-                            const std::string& date, const std::string& source);
+    void addDocumentMetadata(uint32_t doc, std::string_view title,
+                            int64_t published, std::string_view source);
+    
+    /**
+     * @brief Record the number of indexed tokens in a document
+     * @param doc Document ordinal
+     * @param length Token count after stopword removal
+     */
+    void setDocumentLength(uint32_t doc, uint32_t length);
     
     /**
      * @brief Get document metadata
-     * @param docID Document ID
-     * @return Metadata as JSON string
+     * @param doc Document ordinal
+     * @return Title, source and date, viewing the index's storage
      */
-    std::string getDocumentMetadata(const std::string& docID) const;
+    DocumentView getDocumentMetadata(uint32_t doc) const { return documentInfo.get(doc); }
     
     /**
      * @brief Save all indices to files
+     *
+     * Spilled runs are merged into the saved word index and then deleted, which
+     * leaves the in-memory word index empty.
+     *
      * @param basePath Base path for index files
      */
-    void saveIndices(const std::string& basePath) const;
+    void saveIndices(const std::string& basePath);
     
     /**
      * @brief Load all indices from files
@@ -93,29 +408,61 @@ public:
     void loadIndices(const std::string& basePath);
     
     /**
-     * @brief Search for term in word index
-     * @param term Search term
-     * @return Vector of document IDs with scores
+     * @brief Look up the postings of a term in the word index
+     * @param term Stemmed search term
+     * @return Posting list, or nullptr if the term is not indexed
+     */
+    const PostingList* getWordPostings(const std::string& term) const;
+    
+    /**
+     * @brief Indexed words within a few edits of a term
+     *
+     * Intersects the term's Levenshtein automaton with the trie of indexed
+     * words, skipping every prefix the automaton rejects together with all its
+     * words, so only the prefixes near the term are visited however large the
+     * vocabulary. If the trie is out of date, the word index is walked as if it
+     * were one: an ordered lookup finds each distinct next character.
+     *
+     * @param term Stemmed word
+     * @param maxEdits Largest edit distance (at most LevenshteinAutomaton::kMaxEdits)
+     * @param limit Maximum number of words returned
+     * @return Closest words first, then the most frequent
      */
-    std::vector<std::pair<std::string, double>> searchWord(const std::string& term) const;
+    std::vector<std::string> findSimilarWords(const std::string& term, uint32_t maxEdits, size_t limit) const;
     
     /**
-     * @brief Search for organization entity
-     * @param org Organization name
-     * @return Vector of document IDs with scores
+     * @brief Look up the postings of an organization entity
+     * @param org Organization name, matched after normalization and aliasing
+     * @return Posting list, or nullptr if not indexed
      */
-    std::vector<std::pair<std::string, double>> searchOrganization(const std::string& org) const;
+    const PostingList* getOrganizationPostings(std::string_view org) const;
     
     /**
-     * @brief Search for person entity
-     * @param person Person name
-     * @return Vector of document IDs with scores
+     * @brief Look up the postings of a person entity
+     * @param person Person name, matched after normalization and aliasing
+     * @return Posting list, or nullptr if not indexed
+     */
+    const PostingList* getPersonPostings(std::string_view person) const;
+    
+    /**
+     * @brief Check whether a document has been indexed
+     * @param docID Document ID
+     * @return true if registered
+     */
+    bool hasDocument(const std::string& docID) const;
+    
+    /**
+     * @brief Look up the ordinal of a document ID
+     * @param docID Document ID
+     * @return Ordinal (that of the canonical document for a collapsed duplicate),
+     *         or kNoDocument if the ID is not indexed
      */
-    std::vector<std::pair<std::string, double>> searchPerson(const std::string& person) const;
+    uint32_t findDocument(const std::string& docID) const;
     
     /**
      * @brief Register document in index
      * @param docID Document ID
+     * @return Ordinal assigned to the document
      */
-    void registerDocument(const std::string& docID);
-};
\ No newline at end of file
+    uint32_t registerDocument(const std::string& docID);
+};
@@ -0,0 +1,100 @@
+/**
+ * @file LevenshteinAutomaton.h
+ * @author <YourName>
+ * @brief Automaton accepting the strings within a few edits of a term
+ * @version 1.0
+ * @date 2024-03-15
+ *
+ * History:
+ * - 2024-03-15: Initial implementation
+ *
+ * References:
+ * - Schulz, Mihov, "Fast String Correction with Levenshtein-Automata" (2002)
+ */
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Deterministic Levenshtein automaton, built lazily
+ *
+ * A state stands for a row of the edit-distance table: entry i is the distance
+ * between the input read so far and the first i bytes of the term, capped at
+ * maxEdits + 1. Rows are numbered as they are first reached and each
+ * transition is computed once, so a walk over a large dictionary mostly costs
+ * table lookups. Bytes that do not occur in the term share one column of the
+ * table. All rows whose entries exceed maxEdits collapse into a dead state: no
+ * continuation of the input can match, which lets a walk over a sorted
+ * dictionary skip every word with that prefix.
+ *
+ * Distances count bytes (insertions, deletions and substitutions), which for
+ * the ASCII words of the index are characters.
+ */
+class LevenshteinAutomaton {
+public:
+    static constexpr uint32_t kMaxEdits = 2;
+    
+    /**
+     * @brief Constructor
+     * @param term Word to match
+     * @param maxEdits Largest distance accepted (at most kMaxEdits)
+     */
+    LevenshteinAutomaton(std::string_view term, uint32_t maxEdits);
+    
+    /**
+     * @brief State before any input
+     */
+    uint32_t start() const { return kStart; }
+    
+    /**
+     * @brief Follow one input byte, computing the transition on first use
+     * @param state Current state
+     * @param c Input byte
+     * @return Following state
+     */
+    uint32_t step(uint32_t state, unsigned char c);
+    
+    /**
+     * @brief Whether some continuation of the input can still be accepted
+     */
+    bool canMatch(uint32_t state) const { return state != kDead; }
+    
+    /**
+     * @brief Distance between the input read so far and the term
+     * @return Edit distance, or maxEdits + 1 if it is larger
+     */
+    uint32_t distance(uint32_t state) const { return static_cast<uint8_t>(rows[state].back()); }
+    
+    /**
+     * @brief Largest distance accepted
+     */
+    uint32_t getMaxEdits() const { return maxEdits; }
+    
+    /**
+     * @brief Number of states reached so far
+     */
+    size_t stateCount() const { return rows.size(); }
+
+private:
+    static constexpr uint32_t kStart = 0;
+    static constexpr uint32_t kDead = 1;
+    static constexpr uint32_t kUnknown = UINT32_MAX;
+    
+    std::string term;
+    uint8_t maxEdits;
+    std::array<uint8_t, 256> classOf{};                 // byte -> column (0 for bytes not in the term)
+    uint32_t classCount = 1;
+    std::vector<std::string> rows;                      // state -> row of distances
+    std::unordered_map<std::string, uint32_t> states;   // row -> state
+    std::vector<uint32_t> transitions;                  // state * classCount + column -> state
+    
+    /**
+     * @brief Number a row, adding a state if it is new
+     */
+    uint32_t intern(std::string row);
+};
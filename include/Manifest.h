@@ -0,0 +1,103 @@
+/**
+ * @file Manifest.h
+ * @author <YourName>
+ * @brief Record of the article files behind a saved index, for incremental re-indexing
+ * @version 1.0
+ * @date 2024-03-15
+ *
+ * History:
+ * - 2024-03-15: Initial implementation
+ */
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief Maps each indexed article file to its stat data, content hash and ordinal
+ *
+ * Saved next to the index as "<base>.manifest" when a directory is indexed. The
+ * next "index" run over the same directory with the same options compares the
+ * tree against it: files whose size and modification time match are skipped
+ * without being read, files whose stat data changed are re-read and skipped if
+ * their content hash still matches, and everything else is parsed again. The
+ * documents of changed and removed files are tombstoned in the index.
+ */
+class Manifest {
+public:
+    /**
+     * @brief What the index recorded about one file
+     */
+    struct Entry {
+        uint64_t size = 0;
+        int64_t modified = 0;   // last write time in file clock ticks
+        uint64_t hash = 0;      // hashContent of the file
+        uint32_t doc = 0;       // ordinal the article was indexed (or collapsed) as
+    };
+    
+    /**
+     * @brief Stable 64-bit hash of a file's contents
+     */
+    static uint64_t hashContent(std::string_view data);
+    
+    /**
+     * @brief Start an empty manifest for a directory
+     * @param root Indexed directory, stored canonicalized
+     * @param storePositions Whether the index records token positions
+     * @param detectDuplicates Whether the index collapses near-duplicates
+     */
+    void reset(const std::string& root, bool storePositions, bool detectDuplicates);
+    
+    /**
+     * @brief Whether the manifest describes an index of root built with these options
+     */
+    bool matches(const std::string& root, bool storePositions, bool detectDuplicates) const;
+    
+    /**
+     * @brief Load a manifest
+     * @param filename Manifest file
+     * @return false (leaving the manifest empty) if the file is missing or not a manifest
+     */
+    bool load(const std::string& filename);
+    
+    /**
+     * @brief Save the manifest
+     * @param filename Manifest file
+     */
+    void save(const std::string& filename) const;
+    
+    /**
+     * @brief Entry of a file
+     * @param path Path relative to the root
+     * @return The entry, or nullptr if the file is not recorded
+     */
+    const Entry* find(const std::string& path) const;
+    
+    /**
+     * @brief Record or replace a file's entry
+     */
+    void set(const std::string& path, const Entry& entry) { entries[path] = entry; }
+    
+    /**
+     * @brief Forget a file
+     */
+    void erase(const std::string& path) { entries.erase(path); }
+    
+    /**
+     * @brief All entries, keyed by path relative to the root
+     */
+    const std::unordered_map<std::string, Entry>& getEntries() const { return entries; }
+    
+    /**
+     * @brief Canonical path of the indexed directory
+     */
+    const std::string& getRoot() const { return root; }
+
+private:
+    std::string root;
+    bool storePositions = false;
+    bool detectDuplicates = false;
+    std::unordered_map<std::string, Entry> entries;
+};
@@ -0,0 +1,81 @@
+/**
+ * @file PostingIntersection.h
+ * @author <YourName>
+ * @brief Intersection of sorted document ordinals with posting lists
+ * @version 1.0
+ * @date 2024-03-15
+ *
+ * History:
+ * - 2024-03-15: Initial implementation
+ *
+ * References:
+ * - Bentley, Yao, "An almost optimal algorithm for unbounded searching" (1976)
+ * - Lemire, Boytsov, Kurz, "SIMD Compression and the Intersection of Sorted Integers" (2016)
+ */
+
+#pragma once
+#include "PostingList.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Length ratio above which intersectPostings gallops instead of merging
+ *
+ * Galloping costs about log2(gap) probes per candidate and merging about one
+ * comparison per posting, so galloping wins once the list is many times longer
+ * than the candidates.
+ */
+constexpr size_t kGallopRatio = 16;
+
+/**
+ * @brief Find the first posting at or after from whose document is not below doc
+ *
+ * Probes from, from + 1, from + 2, from + 4, ... and binary-searches the last
+ * step, so the cost is logarithmic in the distance skipped rather than in the
+ * list length. Walking a list forward with ascending docs is therefore cheap
+ * whether the targets are dense or sparse.
+ *
+ * @param postings List sorted by document
+ * @param from Index to start from
+ * @param doc Document ordinal to look for
+ * @return Index of the posting, or postings.size() if every document is smaller
+ */
+size_t gallopTo(const std::vector<Posting>& postings, size_t from, uint32_t doc);
+
+/**
+ * @brief Keep the documents that also appear in a much longer list
+ * @param docs Ascending document ordinals, filtered in place
+ * @param postings List sorted by document
+ */
+void intersectGalloping(std::vector<uint32_t>& docs, const std::vector<Posting>& postings);
+
+/**
+ * @brief Keep the documents that also appear in a list of similar length
+ *
+ * A linear merge that compares blocks of four documents against four postings
+ * at once (all sixteen pairs with SSE2), falling back to scalar code at the end
+ * of the lists and on other architectures.
+ *
+ * @param docs Ascending document ordinals, filtered in place
+ * @param postings List sorted by document
+ */
+void intersectMerge(std::vector<uint32_t>& docs, const std::vector<Posting>& postings);
+
+/**
+ * @brief Keep the documents that also appear in postings, galloping or merging by length ratio
+ * @param docs Ascending document ordinals, filtered in place
+ * @param postings List sorted by document
+ */
+void intersectPostings(std::vector<uint32_t>& docs, const std::vector<Posting>& postings);
+
+/**
+ * @brief Remove the documents that appear in postings (an exclusion)
+ *
+ * Gallops from the last match, so a short candidate list costs little even
+ * against a very common excluded word.
+ *
+ * @param docs Ascending document ordinals, filtered in place
+ * @param postings List sorted by document
+ */
+void subtractPostings(std::vector<uint32_t>& docs, const std::vector<Posting>& postings);
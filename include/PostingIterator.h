@@ -0,0 +1,187 @@
+/**
+ * @file PostingIterator.h
+ * @author <YourName>
+ * @brief Doc-at-a-time iterators over posting lists for boolean queries
+ * @version 1.0
+ * @date 2024-03-15
+ *
+ * History:
+ * - 2024-03-15: Initial implementation
+ */
+
+#pragma once
+#include "IndexHandler.h"
+#include "PostingList.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Stream of matching documents in ascending ordinal order
+ *
+ * An iterator is positioned on its first match when constructed. next() moves
+ * to the following match and advance(target) to the first match at or after
+ * target, so a tree of iterators evaluates a boolean query in one pass over
+ * its posting lists without materializing intermediate results. Every call
+ * returns the new document, or kEnd once the stream is exhausted.
+ */
+class PostingIterator {
+public:
+    static constexpr uint32_t kEnd = UINT32_MAX;
+    
+    virtual ~PostingIterator() = default;
+    
+    /**
+     * @brief Current document, or kEnd
+     */
+    uint32_t doc() const { return current; }
+    
+    /**
+     * @brief Move to the next matching document
+     */
+    virtual uint32_t next() = 0;
+    
+    /**
+     * @brief Move to the first matching document not below target (no-op if already there)
+     */
+    virtual uint32_t advance(uint32_t target) = 0;
+    
+    /**
+     * @brief Score of the current document
+     */
+    virtual double score() const = 0;
+    
+    /**
+     * @brief Upper bound on the number of matches, for ordering conjuncts
+     */
+    virtual size_t cost() const = 0;
+
+protected:
+    uint32_t current = kEnd;
+};
+
+using PostingIteratorPtr = std::unique_ptr<PostingIterator>;
+
+/**
+ * @brief Iterator over one posting list
+ *
+ * Scores BM25 when given the index (a word), and a constant otherwise (an
+ * entity boost, or zero for lists that only restrict, such as phrase bigrams).
+ */
+class ListIterator : public PostingIterator {
+public:
+    /**
+     * @brief Word list scored with BM25
+     */
+    ListIterator(const PostingList& list, const IndexHandler& index, double idf, double avgLength);
+    
+    /**
+     * @brief List whose every match scores the same
+     */
+    ListIterator(const PostingList& list, double boost);
+    
+    uint32_t next() override;
+    uint32_t advance(uint32_t target) override;
+    double score() const override;
+    size_t cost() const override { return postings.size(); }
+
+private:
+    const std::vector<Posting>& postings;
+    const IndexHandler* index = nullptr;
+    double idf = 0.0;
+    double avgLength = 0.0;
+    double boost = 0.0;
+    size_t position = 0;
+};
+
+/**
+ * @brief Documents matched by every child; scores the sum of the children
+ *
+ * Children are advanced rarest first: the rarest proposes a document and the
+ * others gallop to it, restarting from any later document one of them reports.
+ */
+class AndIterator : public PostingIterator {
+public:
+    explicit AndIterator(std::vector<PostingIteratorPtr> children);
+    
+    uint32_t next() override;
+    uint32_t advance(uint32_t target) override;
+    double score() const override;
+    size_t cost() const override { return byCost.front()->cost(); }
+
+private:
+    /**
+     * @brief First document not below target on which every child agrees
+     */
+    uint32_t align(uint32_t target);
+    
+    std::vector<PostingIteratorPtr> children;  // query order, for summing scores
+    std::vector<PostingIterator*> byCost;      // ascending cost, for advancing
+};
+
+/**
+ * @brief Documents matched by any child; scores the sum of the children on the document
+ */
+class OrIterator : public PostingIterator {
+public:
+    explicit OrIterator(std::vector<PostingIteratorPtr> children);
+    
+    uint32_t next() override;
+    uint32_t advance(uint32_t target) override;
+    double score() const override;
+    size_t cost() const override;
+
+private:
+    /**
+     * @brief Smallest current document over the children
+     */
+    uint32_t smallest() const;
+    
+    std::vector<PostingIteratorPtr> children;
+};
+
+/**
+ * @brief Documents of one iterator that another does not match; scores the first
+ */
+class AndNotIterator : public PostingIterator {
+public:
+    AndNotIterator(PostingIteratorPtr include, PostingIteratorPtr exclude);
+    
+    uint32_t next() override;
+    uint32_t advance(uint32_t target) override;
+    double score() const override { return include->score(); }
+    size_t cost() const override { return include->cost(); }
+
+private:
+    /**
+     * @brief First document at or after doc (from include) that exclude lacks
+     */
+    uint32_t skipExcluded(uint32_t doc);
+    
+    PostingIteratorPtr include;
+    PostingIteratorPtr exclude;
+};
+
+/**
+ * @brief Documents of an iterator that pass a check, such as phrase positions
+ */
+class FilterIterator : public PostingIterator {
+public:
+    FilterIterator(PostingIteratorPtr child, std::function<bool(uint32_t)> accept);
+    
+    uint32_t next() override;
+    uint32_t advance(uint32_t target) override;
+    double score() const override { return child->score(); }
+    size_t cost() const override { return child->cost(); }
+
+private:
+    /**
+     * @brief First document at or after doc (from child) that passes the check
+     */
+    uint32_t skipRejected(uint32_t doc);
+    
+    PostingIteratorPtr child;
+    std::function<bool(uint32_t)> accept;
+};
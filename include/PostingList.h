@@ -0,0 +1,272 @@
+/**
+ * @file PostingList.h
+ * @author <YourName>
+ * @brief Per-term posting lists keyed by document ordinal
+ * @version 1.0
+ * @date 2024-03-15
+ *
+ * History:
+ * - 2024-03-15: Initial implementation
+ */
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief One (document, term frequency) entry
+ */
+struct Posting {
+    uint32_t doc;  // document ordinal assigned by IndexHandler
+    uint32_t tf;   // occurrences of the term in the document
+};
+
+/**
+ * @brief Summary of a block of consecutive postings, for bounding their scores
+ *
+ * A BM25 term score grows with the term frequency and shrinks with the
+ * document length, so no posting in the block can score above a posting with
+ * maxTf occurrences in a document of minLength tokens.
+ */
+struct PostingBlock {
+    uint32_t lastDoc;    // document of the block's last posting
+    uint32_t maxTf;      // largest term frequency in the block
+    uint32_t minLength;  // shortest document in the block
+};
+
+/**
+ * @brief Postings of one term, sorted by document ordinal
+ *
+ * Documents receive increasing ordinals as they are indexed, so appending keeps
+ * the list sorted. Postings of deleted documents stay in the list, so the
+ * document frequency is its length less the ones counted by markDeleted.
+ *
+ * Lists built with positions also keep, for every posting, the token positions
+ * of the term in that document (tf of them, ascending). They are stored as
+ * varint-encoded gaps in one byte array and decoded only when a query needs
+ * them, i.e. for the few candidates of a phrase query.
+ *
+ * Block summaries of kBlockSize postings let ranked queries skip postings that
+ * cannot reach the top results. They depend on document lengths, so the index
+ * builds them (buildBlocks) once its documents are in; they are not saved.
+ */
+struct PostingList {
+    static constexpr size_t kBlockSize = 64;
+    
+    std::vector<Posting> postings;
+    std::vector<uint32_t> positionOffsets;  // per posting: start of its positions in positionData
+    std::vector<uint8_t> positionData;      // varint gaps between successive positions
+    std::vector<PostingBlock> blocks;       // per kBlockSize postings, see buildBlocks
+    uint32_t deletedPostings = 0;           // postings of deleted documents, see markDeleted
+    
+    /**
+     * @brief Append a posting for a newer document (or add to the last one)
+     * @param doc Document ordinal, not smaller than any already present
+     * @param tf Term frequency
+     */
+    void add(uint32_t doc, uint32_t tf) {
+        if (!postings.empty() && postings.back().doc == doc) {
+            postings.back().tf += tf;
+            return;
+        }
+        if (!postings.empty() && postings.back().doc > doc) {
+            throw std::logic_error("Postings must be added in document order");
+        }
+        postings.push_back({doc, tf});
+    }
+    
+    /**
+     * @brief Append a posting for a newer document together with its positions
+     * @param doc Document ordinal, larger than any already present
+     * @param positions Ascending token positions; the term frequency is their count
+     * @param count Number of positions
+     */
+    void addWithPositions(uint32_t doc, const uint32_t* positions, uint32_t count) {
+        if (!postings.empty() && postings.back().doc >= doc) {
+            throw std::logic_error("Positional postings must be added once per document, in order");
+        }
+        if (positionOffsets.size() != postings.size()) {
+            throw std::logic_error("Cannot mix positional and non-positional postings");
+        }
+        
+        postings.push_back({doc, count});
+        positionOffsets.push_back(static_cast<uint32_t>(positionData.size()));
+        
+        uint32_t previous = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t gap = positions[i] - previous;
+            previous = positions[i];
+            while (gap >= 0x80) {
+                positionData.push_back(static_cast<uint8_t>(gap | 0x80));
+                gap >>= 7;
+            }
+            positionData.push_back(static_cast<uint8_t>(gap));
+        }
+    }
+    
+    /**
+     * @brief Append the postings of a later part of the collection
+     *
+     * Used to join the pieces of one term's list from consecutive index runs.
+     * Positions are kept only if both parts have them.
+     *
+     * @param other Postings whose documents all follow the documents of this list
+     */
+    void append(const PostingList& other) {
+        if (other.postings.empty()) {
+            return;
+        }
+        if (!postings.empty() && postings.back().doc >= other.postings.front().doc) {
+            throw std::logic_error("Appended postings must follow existing documents");
+        }
+        
+        if ((postings.empty() || hasPositions()) && other.hasPositions()) {
+            uint32_t base = static_cast<uint32_t>(positionData.size());
+            for (uint32_t offset : other.positionOffsets) {
+                positionOffsets.push_back(base + offset);
+            }
+            positionData.insert(positionData.end(), other.positionData.begin(), other.positionData.end());
+        }
+        else {
+            positionOffsets.clear();
+            positionData.clear();
+        }
+        postings.insert(postings.end(), other.postings.begin(), other.postings.end());
+    }
+    
+    /**
+     * @brief Whether every posting carries positions
+     */
+    bool hasPositions() const {
+        return !postings.empty() && positionOffsets.size() == postings.size();
+    }
+    
+    /**
+     * @brief Decode the positions of one posting
+     * @param index Index into postings
+     * @param out Receives postings[index].tf ascending positions
+     */
+    void decodePositions(size_t index, std::vector<uint32_t>& out) const {
+        out.clear();
+        const uint8_t* data = positionData.data() + positionOffsets[index];
+        uint32_t position = 0;
+        for (uint32_t i = 0; i < postings[index].tf; ++i) {
+            uint32_t gap = 0;
+            int shift = 0;
+            while (*data & 0x80) {
+                gap |= static_cast<uint32_t>(*data++ & 0x7F) << shift;
+                shift += 7;
+            }
+            gap |= static_cast<uint32_t>(*data++) << shift;
+            position += gap;
+            out.push_back(position);
+        }
+    }
+    
+    /**
+     * @brief Index of the posting for a document
+     * @param doc Document ordinal
+     * @return Index into postings, or postings.size() if the document is absent
+     */
+    size_t findDocument(uint32_t doc) const {
+        auto it = std::lower_bound(postings.begin(), postings.end(), doc,
+                                   [](const Posting& posting, uint32_t d) { return posting.doc < d; });
+        return it != postings.end() && it->doc == doc ? static_cast<size_t>(it - postings.begin())
+                                                      : postings.size();
+    }
+    
+    /**
+     * @brief Summarize the postings added since the blocks were last built
+     * @param documentLengths Indexed token count of every document, by ordinal
+     */
+    void buildBlocks(const std::vector<uint32_t>& documentLengths) {
+        // The last block may have been partial, so it is rebuilt
+        size_t start = blocks.empty() ? 0 : (blocks.size() - 1) * kBlockSize;
+        blocks.resize(start / kBlockSize);
+        for (size_t begin = start; begin < postings.size(); begin += kBlockSize) {
+            size_t end = std::min(begin + kBlockSize, postings.size());
+            PostingBlock block{postings[end - 1].doc, 0, UINT32_MAX};
+            for (size_t i = begin; i < end; ++i) {
+                block.maxTf = std::max(block.maxTf, postings[i].tf);
+                block.minLength = std::min(block.minLength, documentLengths[postings[i].doc]);
+            }
+            blocks.push_back(block);
+        }
+    }
+    
+    /**
+     * @brief Whether the blocks summarize every posting
+     */
+    bool hasBlocks() const {
+        return blocks.size() == (postings.size() + kBlockSize - 1) / kBlockSize &&
+               (blocks.empty() || blocks.back().lastDoc == postings.back().doc);
+    }
+    
+    /**
+     * @brief Count the postings of newly deleted documents
+     * @param docs Documents deleted since the last call, ascending
+     */
+    void markDeleted(const std::vector<uint32_t>& docs) {
+        auto from = postings.begin();
+        for (uint32_t doc : docs) {
+            from = std::lower_bound(from, postings.end(), doc, [](const Posting& posting, uint32_t target) {
+                return posting.doc < target;
+            });
+            if (from == postings.end()) {
+                break;
+            }
+            if (from->doc == doc) {
+                ++deletedPostings;
+            }
+        }
+    }
+    
+    /**
+     * @brief Number of documents not deleted containing the term
+     */
+    size_t documentFrequency() const {
+        return postings.size() - deletedPostings;
+    }
+    
+    /**
+     * @brief Bytes allocated for postings and positions
+     */
+    size_t memoryUsage() const {
+        return postings.capacity() * sizeof(Posting) + positionOffsets.capacity() * sizeof(uint32_t) +
+               positionData.capacity();
+    }
+    
+    void write(std::ofstream& out) const {
+        size_t count = postings.size();
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        out.write(reinterpret_cast<const char*>(postings.data()), count * sizeof(Posting));
+        
+        size_t offsetCount = positionOffsets.size();
+        out.write(reinterpret_cast<const char*>(&offsetCount), sizeof(offsetCount));
+        out.write(reinterpret_cast<const char*>(positionOffsets.data()), offsetCount * sizeof(uint32_t));
+        size_t dataSize = positionData.size();
+        out.write(reinterpret_cast<const char*>(&dataSize), sizeof(dataSize));
+        out.write(reinterpret_cast<const char*>(positionData.data()), dataSize);
+    }
+    
+    void read(std::ifstream& in) {
+        size_t count = 0;
+        in.read(reinterpret_cast<char*>(&count), sizeof(count));
+        postings.resize(count);
+        in.read(reinterpret_cast<char*>(postings.data()), count * sizeof(Posting));
+        
+        size_t offsetCount = 0;
+        in.read(reinterpret_cast<char*>(&offsetCount), sizeof(offsetCount));
+        positionOffsets.resize(offsetCount);
+        in.read(reinterpret_cast<char*>(positionOffsets.data()), offsetCount * sizeof(uint32_t));
+        size_t dataSize = 0;
+        in.read(reinterpret_cast<char*>(&dataSize), sizeof(dataSize));
+        positionData.resize(dataSize);
+        in.read(reinterpret_cast<char*>(positionData.data()), dataSize);
+        blocks.clear();
+        deletedPostings = 0;
+    }
+};
@@ -0,0 +1,138 @@
+/**
+ * @file QueryCache.h
+ * @author <YourName>
+ * @brief Bounded, thread-safe cache of ranked query results
+ * @version 1.0
+ * @date 2024-03-15
+ *
+ * History:
+ * - 2024-03-15: Initial implementation
+ */
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Cache from normalized query to its ranked documents
+ *
+ * Entries hold (score, ordinal) pairs rather than display results, so they are
+ * small and their titles and dates are always read from the index. Each entry
+ * records the index generation it was computed at; a lookup at a different
+ * generation drops it, so any change to the index invalidates every entry
+ * without a sweep. Keys are spread over independently locked shards, each an
+ * LRU list bounded by its share of the byte capacity.
+ *
+ * A cache must only serve queries against one index.
+ */
+class QueryCache {
+public:
+    using RankedDocuments = std::vector<std::pair<double, uint32_t>>;  // (score, ordinal), best first
+    
+    /**
+     * @brief Cache counters
+     */
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;           // including stale entries
+        uint64_t invalidations = 0;    // entries dropped for an older generation
+        uint64_t evictions = 0;        // entries dropped to stay within capacity
+        uint64_t entries = 0;
+        uint64_t bytes = 0;
+        
+        double hitRate() const {
+            uint64_t total = hits + misses;
+            return total ? static_cast<double>(hits) / total : 0.0;
+        }
+    };
+    
+    /**
+     * @brief Constructor
+     * @param capacityBytes Approximate memory limit over all shards
+     */
+    explicit QueryCache(size_t capacityBytes = 16 << 20);
+    
+    QueryCache(const QueryCache&) = delete;
+    QueryCache& operator=(const QueryCache&) = delete;
+    
+    /**
+     * @brief Look up a query
+     * @param key Normalized query
+     * @param generation Current index generation
+     * @param documents Receives the cached ranking on a hit
+     * @return true on a hit
+     */
+    bool find(const std::string& key, uint64_t generation, RankedDocuments& documents);
+    
+    /**
+     * @brief Store the ranking of a query, evicting the least recently used entries as needed
+     * @param key Normalized query
+     * @param generation Index generation the ranking was computed at
+     * @param documents Ranked documents
+     */
+    void insert(const std::string& key, uint64_t generation, const RankedDocuments& documents);
+    
+    /**
+     * @brief Remove every entry (the counters are kept)
+     */
+    void clear();
+    
+    /**
+     * @brief Snapshot of the counters
+     * @return Aggregated statistics over all shards
+     */
+    Stats getStats() const;
+
+private:
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+    
+    struct Entry {
+        std::string key;
+        uint64_t generation;
+        RankedDocuments documents;
+        size_t bytes;                    // counted toward the shard's capacity
+    };
+    
+    using EntryList = std::list<Entry>;  // most recently used first
+    
+    // Counters change under the shard lock, so lookups in different shards
+    // share no cache lines
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        EntryList entries;
+        std::unordered_map<std::string_view, EntryList::iterator, StringHash> index;  // views into keys
+        size_t bytes = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t invalidations = 0;
+        uint64_t evictions = 0;
+    };
+    
+    /**
+     * @brief Approximate memory held by an entry, including list and map nodes
+     */
+    static size_t entryBytes(const Entry& entry);
+    
+    /**
+     * @brief Unlink an entry (shard lock held)
+     */
+    void erase(Shard& shard, EntryList::iterator entry);
+    
+    Shard& shardFor(std::string_view key) { return shards[(StringHash{}(key) >> 7) % kShardCount]; }
+    
+    static constexpr size_t kShardCount = 16;
+    
+    std::array<Shard, kShardCount> shards;
+    size_t shardCapacity;
+};
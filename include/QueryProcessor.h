@@ -11,7 +11,14 @@
 
 #pragma once
 #include "IndexHandler.h"
+#include "PostingIterator.h"
+#include "QueryCache.h"
+#include "Tokenizer.h"
+#include "StopwordSet.h"
+#include <iosfwd>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 
@@ -26,33 +33,348 @@ struct QueryResult {
     QueryResult(const std::string& id, double s) : docID(id), score(s) {}
 };
 
+/**
+ * @brief A quoted phrase: terms that must appear in order at fixed token offsets
+ */
+struct PhraseQuery {
+    std::vector<std::string> terms;  // stemmed, stopwords removed
+    std::vector<uint32_t> offsets;   // token offset of each term from the first
+    uint32_t slop = 0;               // extra tokens allowed in total ("..."~N)
+};
+
+/**
+ * @brief Components of a query in flat form (see QueryProcessor::flattenQuery)
+ *
+ * Words, entity names and exclusions are sorted (entity names normalized,
+ * exclusions deduplicated), so equivalent queries parse identically.
+ */
+struct ParsedQuery {
+    std::vector<std::string> terms;       // includes the terms of every phrase
+    std::vector<std::string> orgs;
+    std::vector<std::string> persons;
+    std::vector<std::string> exclusions;
+    std::vector<PhraseQuery> phrases;
+    bool anyTerm = false;                 // "OR" given: rank documents with any of the terms
+    std::vector<std::string> stopwords;   // words dropped from the query, for explain
+};
+
+/**
+ * @brief Node of a boolean query expression
+ *
+ * Grammar, loosest binding first (AND may be left out between operands):
+ *
+ *     query       := disjunction
+ *     disjunction := conjunction ("OR" conjunction)*
+ *     conjunction := unary (["AND"] unary)*
+ *     unary       := ("NOT" | "-") unary | primary
+ *     primary     := "(" disjunction ")" | phrase | ORG:name | PERSON:name | word
+ *
+ * Operators are recognized in upper case only. Nested operators of the same
+ * kind are merged, and operators left with one operand are replaced by it.
+ */
+struct QueryNode {
+    enum class Type { Word, Organization, Person, Phrase, And, Or, Not };
+    
+    Type type = Type::Word;
+    std::string value;               // Word: stemmed term; Organization, Person: normalized name
+    PhraseQuery phrase;              // Phrase only
+    std::vector<QueryNode> children; // And, Or: operands; Not: the negated operand
+};
+
 class QueryProcessor {
+public:
+    static constexpr size_t kResultLimit = 15;  // results returned by processQuery
+
 private:
     IndexHandler& indexHandler;
+    const StopwordSet& stopwords;
+    Tokenizer tokenizer;
+    std::vector<std::vector<uint32_t>> phrasePositions;  // decoding scratch, one per phrase unit
+    std::vector<uint32_t> candidateScratch;              // documents surviving the AND so far
+    bool pruning = true;                                 // skip postings in ranked OR queries
+    QueryCache* cache = nullptr;                         // rankings of earlier queries, if set
+    bool unverifiedPhrases = false;                      // last query had a phrase matched as plain AND
+    
+    using ScoredDocument = QueryCache::RankedDocuments::value_type;  // (score, ordinal)
+    
+    /**
+     * @brief A position in one posting list of a ranked OR query
+     *
+     * Words score BM25; entities add a constant boost per matching document.
+     * maxScore bounds every posting of the list and the block bound every
+     * posting of the current block.
+     */
+    struct ScoreCursor {
+        const PostingList* list;
+        double idf = 0.0;       // words only
+        double boost = 0.0;     // entities only
+        double maxScore = 0.0;
+        size_t index = 0;       // current posting
+        size_t block = 0;       // block holding the current posting or the last target
+    };
+    
+    /**
+     * @brief Posting lists that verify a phrase
+     *
+     * Adjacent phrase words that form an indexed bigram are replaced by the
+     * bigram's list, so a phrase can need fewer (and much shorter) lists than
+     * it has terms. A phrase that is exactly one bigram needs no position checks.
+     */
+    struct PhrasePlan {
+        std::vector<const PostingList*> lists;  // per unit: a word or a bigram
+        std::vector<uint32_t> offsets;          // token offset of each unit's first word
+        std::vector<std::string> units;         // each unit's words, for explain
+        uint32_t slop = 0;
+        bool positional = true;                 // false if the index lacks positions
+        bool empty = false;                     // a unit has no postings at all
+    };
+    
+    /**
+     * @brief One posting list a query reads, with its cost
+     */
+    struct PlanOperand {
+        std::string kind;                  // "word", "org", "person" or "bigram"
+        std::string label;
+        const PostingList* list = nullptr; // nullptr if nothing is indexed under it
+        size_t documentFrequency = 0;
+    };
+    
+    /**
+     * @brief Evaluation order of a query
+     *
+     * For AND queries the conjuncts are intersected rarest first, so the
+     * candidates start small and long lists are only galloped through;
+     * exclusions are subtracted from the candidates before any scoring. A
+     * conjunct without postings makes the plan empty and nothing is read.
+     */
+    struct QueryPlan {
+        std::vector<PlanOperand> conjuncts;   // ascending document frequency
+        std::vector<PlanOperand> exclusions;  // ascending document frequency
+        std::vector<PhrasePlan> phrases;      // verified on the surviving candidates
+        bool empty = false;                   // a conjunct has no postings: nothing can match
+    };
     
     /**
-     * @brief Parse query string into components
+     * @brief Collect the posting lists of a query and order them by cost
+     * @param parsed Parsed query
+     * @return Plan; for OR queries the conjuncts are the optional lists
+     */
+    QueryPlan planQuery(const ParsedQuery& parsed) const;
+    
+    /**
+     * @brief Documents matching every conjunct and no exclusion, with their scores
+     * @param parsed Parsed AND query
+     * @param plan Plan of the query
+     * @return Scores of the matches (empty if the plan is)
+     */
+    std::unordered_map<uint32_t, double> evaluateConjunction(const ParsedQuery& parsed,
+                                                             const QueryPlan& plan);
+    
+    /**
+     * @brief Choose the posting lists that verify a phrase
+     * @param phrase Parsed phrase
+     * @return Plan for applyPhrase
+     */
+    PhrasePlan planPhrase(const PhraseQuery& phrase) const;
+    
+    /**
+     * @brief Whether a query has a phrase whose positions the index cannot check
+     */
+    bool hasUnverifiedPhrase(const QueryNode& node) const;
+    
+    /**
+     * @brief Lexical unit of a query string
+     */
+    struct QueryToken {
+        enum class Kind { Word, Phrase, Open, Close, Minus };
+        Kind kind;
+        std::string text;   // Word: as typed (including AND/OR/NOT); Phrase: between the quotes
+        uint32_t slop;      // Phrase: "..."~N
+    };
+    
+    /**
+     * @brief Split a query into words, quoted phrases, parentheses and leading '-'
+     */
+    static std::vector<QueryToken> lexQuery(const std::string& query);
+    
+    /**
+     * @brief Parse a query string into an expression
      * @param query User query string
-     * @return Tuple of terms, organizations, persons, exclusions
+     * @param droppedStopwords Receives the stopwords left out of the expression
+     * @return Expression, or nothing if no operand remains
+     */
+    std::optional<QueryNode> parseQuery(const std::string& query, std::vector<std::string>& droppedStopwords);
+    
+    // Recursive descent over the grammar of QueryNode; each consumes at least one token
+    std::optional<QueryNode> parseDisjunction(const std::vector<QueryToken>& tokens, size_t& pos,
+                                              std::vector<std::string>& dropped);
+    std::optional<QueryNode> parseConjunction(const std::vector<QueryToken>& tokens, size_t& pos,
+                                              std::vector<std::string>& dropped);
+    std::optional<QueryNode> parseUnary(const std::vector<QueryToken>& tokens, size_t& pos,
+                                        std::vector<std::string>& dropped);
+    std::optional<QueryNode> parsePrimary(const std::vector<QueryToken>& tokens, size_t& pos,
+                                          std::vector<std::string>& dropped);
+    
+    /**
+     * @brief Merge nested operators of the node's kind and unwrap a single operand
+     * @return The simplified node, or nothing if it has no operands
+     */
+    static std::optional<QueryNode> combine(QueryNode node);
+    
+    /**
+     * @brief Express a query in the flat form of the term-at-a-time paths, if it has one
+     *
+     * That form is a conjunction of words, entities, phrases and word exclusions,
+     * or a disjunction of words and entities with word exclusions. Its lists are
+     * sorted (exclusions deduplicated), so equivalent queries flatten identically.
+     *
+     * @param root Parsed expression
+     * @param parsed Receives the flat query
+     * @return false if the expression needs the iterator tree
+     */
+    static bool flattenQuery(const QueryNode& root, ParsedQuery& parsed);
+    
+    /**
+     * @brief Sort the operands of every AND and OR into a canonical order
+     * @param node Expression, reordered in place
+     * @return Key that equals another's exactly when the expressions are equivalent this way
+     */
+    static std::string canonicalize(QueryNode& node);
+    
+    /**
+     * @brief Build the iterator tree that streams the matches of an expression
+     * @param node Expression
+     * @return Iterator, or nullptr if nothing can match
+     */
+    PostingIteratorPtr compile(const QueryNode& node);
+    
+    /**
+     * @brief Best documents for an expression in one pass over its iterator tree
+     * @param root Expression
+     * @return Up to kResultLimit (score, ordinal) pairs, best first
+     */
+    std::vector<ScoredDocument> rankExpression(const QueryNode& root);
+    
+    /**
+     * @brief Write one node of an expression plan, indented by depth
+     */
+    void explainNode(const QueryNode& node, size_t depth, std::ostream& out) const;
+    
+    /**
+     * @brief Cache key of a parsed query
+     * @param parsed Query in canonical order
+     * @return Key that equals another's exactly when the queries are equivalent
+     */
+    static std::string cacheKey(const ParsedQuery& parsed);
+    
+    /**
+     * @brief Best documents for a query, best first
+     * @param parsed Parsed query
+     * @return Up to kResultLimit (score, ordinal) pairs
+     */
+    std::vector<ScoredDocument> rankQuery(const ParsedQuery& parsed);
+    
+    /**
+     * @brief Add the contents of a quoted phrase to a parsed query
+     * @param text Text between the quotes
+     * @param slop Extra tokens allowed between the phrase terms
+     * @param parsed Query receiving the phrase (or a plain term if only one remains)
+     */
+    void addPhrase(std::string_view text, uint32_t slop, ParsedQuery& parsed);
+    
+    /**
+     * @brief Keep only candidates in which the phrase occurs
+     * @param results Candidates, already restricted to documents with every phrase term
+     * @param plan Lists and offsets that verify the phrase
+     */
+    void applyPhrase(std::unordered_map<uint32_t, double>& results, const PhrasePlan& plan);
+    
+    /**
+     * @brief Check phrase positions in one document
+     * @param plan Lists (with positions) and offsets of the phrase units
+     * @param doc Candidate document ordinal
+     * @return true if the units occur in order within the phrase's slop
+     */
+    bool matchesPhrase(const PhrasePlan& plan, uint32_t doc);
+    
+    /**
+     * @brief Top documents of a ranked OR query, skipping those that cannot qualify
+     *
+     * Block-Max WAND: cursors are ordered by document, and the first document
+     * whose preceding lists' maximum scores could beat the current k-th score
+     * is a candidate. It is scored only if the bounds of the blocks holding it
+     * also could; otherwise every cursor involved jumps past those blocks. The
+     * result is the exact top-k of exhaustive evaluation, including exclusions,
+     * tombstones and the ordinal tie-break.
+     *
+     * @param query Parsed query without phrases
+     * @param limit Number of results
+     * @param top Receives the best documents, best first
+     * @return false if some word list has no block summaries (nothing is computed)
      */
-    std::tuple<std::vector<std::string>, std::vector<std::string>, 
-              std::vector<std::string>, std::vector<std::string>> 
-    parseQuery(const std::string& query);
+    bool rankDisjunction(const ParsedQuery& query, size_t limit, std::vector<ScoredDocument>& top);
     
     /**
-     * @brief Apply exclusion filters to results
-     * @param results Current results
-     * @param exclusions Terms to exclude
+     * @brief Best documents of a score map, best first (ties in ordinal order)
      */
-    void applyExclusions(std::unordered_map<std::string, double>& results, 
-                        const std::vector<std::string>& exclusions);
-                        
+    std::vector<ScoredDocument> selectTop(const std::unordered_map<uint32_t, double>& scores,
+                                          size_t limit) const;
+    
+    /**
+     * @brief Build results with IDs and display metadata for ranked documents
+     */
+    std::vector<QueryResult> materializeResults(const std::vector<ScoredDocument>& top) const;
+    
+    /**
+     * @brief BM25 inverse document frequency from current collection statistics
+     * @param docFreq Number of documents containing the term
+     * @return IDF weight (never negative)
+     */
+    double inverseDocumentFrequency(size_t docFreq) const;
+    
+    /**
+     * @brief BM25 contribution of one posting
+     * @param posting Document and term frequency
+     * @param idf Inverse document frequency of the term
+     * @param avgLength Average document length of the collection
+     * @return Score contribution
+     */
+    double termScore(const Posting& posting, double idf, double avgLength) const;
+
 public:
+    /**
+     * @brief BM25 term score from its parts
+     * @param tf Term frequency
+     * @param docLength Indexed tokens in the document
+     * @param idf Inverse document frequency of the term
+     * @param avgLength Average document length of the collection
+     * @return Score contribution (increasing in tf, decreasing in docLength)
+     */
+    static double bm25(double tf, double docLength, double idf, double avgLength);
+    
     /**
      * @brief Constructor
      * @param handler Reference to index handler
+     * @param stopwords Stopwords to drop from queries (same set used for indexing)
      */
-    QueryProcessor(IndexHandler& handler) : indexHandler(handler) {}
+    QueryProcessor(IndexHandler& handler, const StopwordSet& stopwords) 
+        : indexHandler(handler), stopwords(stopwords) {}
+    
+    /**
+     * @brief Choose whether ranked OR queries skip postings (the default)
+     * @param enabled false to score every posting, e.g. to compare against
+     */
+    void setPruning(bool enabled) { pruning = enabled; }
+    
+    /**
+     * @brief Reuse rankings from a cache shared by processors of this index
+     *
+     * Results are looked up by the parsed query and stay valid until the index
+     * generation changes.
+     *
+     * @param queryCache Cache, or nullptr to rank every query
+     */
+    void setCache(QueryCache* queryCache) { cache = queryCache; }
     
     /**
      * @brief Process search query
@@ -61,15 +383,34 @@ public:
      */
     std::vector<QueryResult> processQuery(const std::string& query);
     
+    /**
+     * @brief Whether the last processed query matched a phrase as a plain AND
+     *
+     * Happens when the index was built without --positions; the caller may tell
+     * the user to re-index.
+     */
+    bool matchedPhrasesWithoutPositions() const { return unverifiedPhrases; }
+    
+    /**
+     * @brief Describe how a query would be evaluated
+     * @param query User query string
+     * @return Human-readable plan: operands with document frequencies in evaluation order
+     */
+    std::string explain(const std::string& query);
+    
     /**
      * @brief Rank search results by relevance
-     * @param rawScores Map of document IDs to scores
+     *
+     * Selects the best documents with a bounded heap and loads title, date and
+     * source only for those, so broad queries cost little beyond scoring.
+     *
+     * @param rawScores Map of document ordinals to scores
      * @param limit Maximum number of results to return
-     * @return Sorted vector of query results
+     * @return Highest scores first; ties in ingestion order
      */
     std::vector<QueryResult> rankResults(
-        const std::unordered_map<std::string, double>& rawScores, size_t limit = 15);
-        
+        const std::unordered_map<uint32_t, double>& rawScores, size_t limit = kResultLimit);
+    
     /**
      * @brief Get full article text
      * @param docID Document ID
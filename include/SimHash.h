@@ -0,0 +1,147 @@
+/**
+ * @file SimHash.h
+ * @author <YourName>
+ * @brief SimHash fingerprints and a banded index for near-duplicate detection
+ * @version 1.0
+ * @date 2024-03-15
+ *
+ * History:
+ * - 2024-03-15: Initial implementation
+ *
+ * References:
+ * - Charikar, "Similarity Estimation Techniques from Rounding Algorithms" (STOC 2002)
+ * - Manku, Jain, Das Sarma, "Detecting Near-Duplicates for Web Crawling" (WWW 2007)
+ */
+
+#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Builds the 64-bit SimHash of a set of weighted features
+ *
+ * Every feature hash votes on each of the 64 bits (+1 where its bit is set, -1
+ * where it is not) and the fingerprint keeps the bits with a positive total.
+ * Documents sharing most of their features therefore differ in only a few bits,
+ * unlike an ordinary hash where one changed word flips half of them.
+ */
+class SimHash {
+public:
+    /**
+     * @brief Stable 64-bit hash of a string (FNV-1a with a final mix)
+     *
+     * Fingerprints are saved with the index, so the hash must not depend on the
+     * standard library implementation.
+     */
+    static uint64_t hash(std::string_view text);
+    
+    /**
+     * @brief Combine feature hashes into one, e.g. a pair of consecutive terms
+     */
+    static uint64_t combine(uint64_t seed, uint64_t value) {
+        return mix(seed ^ (value + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2)));
+    }
+    
+    /**
+     * @brief Number of differing bits between two fingerprints
+     */
+    static int distance(uint64_t a, uint64_t b) {
+        return std::popcount(a ^ b);
+    }
+    
+    /**
+     * @brief Add one feature with weight 1
+     * @param feature Hash of the feature
+     */
+    void add(uint64_t feature);
+    
+    /**
+     * @brief Fingerprint of the features added so far (0 if none were added)
+     */
+    uint64_t fingerprint() const;
+    
+    /**
+     * @brief Forget all features
+     */
+    void clear() {
+        votes.fill(0);
+        features = 0;
+    }
+
+private:
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xFF51AFD7ED558CCDULL;
+        x ^= x >> 33;
+        x *= 0xC4CEB9FE1A85EC53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+    
+    std::array<int32_t, 64> votes{};
+    uint32_t features = 0;
+};
+
+/**
+ * @brief Finds documents whose fingerprints differ in at most a few bits
+ *
+ * The fingerprint is cut into kBands bands of 10 or 11 bits and each band
+ * indexes the documents by its value. Two fingerprints within kMaxDistance <
+ * kBands bits of each other agree on at least one whole band (pigeonhole), so
+ * checking the documents that share a band with the query finds every
+ * near-duplicate while comparing against roughly 1/256 of the collection.
+ */
+class SimHashIndex {
+public:
+    static constexpr int kBands = 6;
+    static constexpr int kMaxDistance = 5;
+    static constexpr uint32_t kNotFound = UINT32_MAX;
+    
+    /**
+     * @brief Add a document's fingerprint
+     * @param doc Document ordinal
+     * @param fingerprint SimHash; 0 means "no fingerprint" and is not indexed
+     */
+    void insert(uint32_t doc, uint64_t fingerprint);
+    
+    /**
+     * @brief Find an indexed document within kMaxDistance bits
+     * @param fingerprint SimHash of the new document
+     * @return Ordinal of the earliest such document, or kNotFound
+     */
+    uint32_t find(uint64_t fingerprint) const;
+    
+    /**
+     * @brief Stop matching a document; its bucket entries are skipped from then on
+     * @param doc Document ordinal
+     */
+    void erase(uint32_t doc);
+    
+    /**
+     * @brief Fingerprint of every document ordinal (0 where none was inserted)
+     */
+    const std::vector<uint64_t>& fingerprints() const { return documentFingerprints; }
+    
+    /**
+     * @brief Remove all documents
+     */
+    void clear();
+
+private:
+    static constexpr int kBandBits = 11;  // the last two bands have 10
+    
+    /**
+     * @brief Bucket of a fingerprint in band b
+     */
+    static size_t bucket(uint64_t fingerprint, int b) {
+        int shift = b < 4 ? b * kBandBits : 4 * kBandBits + (b - 4) * (kBandBits - 1);
+        int bits = b < 4 ? kBandBits : kBandBits - 1;
+        return (static_cast<size_t>(b) << kBandBits) | ((fingerprint >> shift) & ((1ULL << bits) - 1));
+    }
+    
+    std::vector<uint64_t> documentFingerprints;        // ordinal -> fingerprint
+    std::vector<std::vector<uint32_t>> buckets;        // bucket(fingerprint, band) -> ordinals
+};
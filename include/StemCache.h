@@ -0,0 +1,107 @@
+/**
+ * @file StemCache.h
+ * @author <YourName>
+ * @brief Bounded, thread-safe memoization of Porter2 stems
+ * @version 1.0
+ * @date 2024-03-15
+ *
+ * History:
+ * - 2024-03-15: Initial implementation
+ */
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief Cache from surface form to Porter2 stem
+ *
+ * Keys are spread over independently locked shards so several ingest threads can
+ * stem concurrently. Each shard keeps two generations: lookups check the current
+ * one, then the previous one (promoting hits), and when the current generation
+ * fills up it replaces the previous one. Frequently seen words therefore stay
+ * cached while memory is bounded by the configured capacity.
+ */
+class StemCache {
+public:
+    /**
+     * @brief Cache counters
+     */
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t entries = 0;
+        double avgHitNanos = 0.0;   // sampled lookup time on hits
+        double avgMissNanos = 0.0;  // sampled lookup plus stemming time on misses
+
+        double hitRate() const {
+            uint64_t total = hits + misses;
+            return total ? static_cast<double>(hits) / total : 0.0;
+        }
+    };
+
+    /**
+     * @brief Constructor
+     * @param capacity Maximum number of cached words across all shards
+     */
+    explicit StemCache(size_t capacity = 1 << 18);
+
+    StemCache(const StemCache&) = delete;
+    StemCache& operator=(const StemCache&) = delete;
+
+    /**
+     * @brief Replace word with its stem, using the cache when possible
+     * @param word Lowercased surface form, stemmed in place
+     */
+    void stem(std::string& word);
+
+    /**
+     * @brief Snapshot of the counters
+     * @return Aggregated statistics over all shards
+     */
+    Stats getStats() const;
+
+    /**
+     * @brief Process-wide cache shared by the parser and query processor
+     * @return Shared instance
+     */
+    static StemCache& shared();
+
+private:
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    using StemMap = std::unordered_map<std::string, std::string, StringHash, std::equal_to<>>;
+
+    // Counters live with the map they describe and change under its lock, so
+    // threads stemming in different shards share no cache lines
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        StemMap current;
+        StemMap previous;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t sampledHits = 0;
+        uint64_t sampledHitNanos = 0;
+        uint64_t sampledMisses = 0;
+        uint64_t sampledMissNanos = 0;
+    };
+
+    /**
+     * @brief Retire the current generation if it is full (shard lock held)
+     */
+    void rotateIfFull(Shard& shard) const;
+
+    static constexpr size_t kShardCount = 32;
+    static constexpr uint64_t kSampleMask = 63;  // time one call in 64 per thread
+
+    std::array<Shard, kShardCount> shards;
+    size_t generationCapacity;
+};
@@ -0,0 +1,209 @@
+/**
+ * @file StopwordSet.h
+ * @author <YourName>
+ * @brief Stopword lookup backed by a compile-time perfect hash table
+ * @version 1.0
+ * @date 2024-03-15
+ *
+ * History:
+ * - 2024-03-15: Initial implementation
+ *
+ * References:
+ * - Belazzougui, Botelho, Dietzfelbinger, "Hash, displace, and compress" (ESA 2009)
+ */
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace stopword_table {
+
+// Generated at configure time from stopwords.txt
+inline constexpr std::string_view kDefaultWords[] = {
+#include "DefaultStopwords.inc"
+};
+
+inline constexpr size_t kWordCount = std::size(kDefaultWords);
+
+constexpr size_t ceilPow2(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+// Load factor ~0.7 in the slot array, ~3 words per displacement bucket
+inline constexpr size_t kSlotCount = ceilPow2(kWordCount + kWordCount / 4 + 1);
+inline constexpr size_t kBucketCount = ceilPow2(kWordCount / 4 + 1);
+
+/**
+ * @brief Seeded FNV-1a with a final avalanche step
+ */
+constexpr uint64_t hash(std::string_view word, uint64_t seed) {
+    uint64_t h = 0xcbf29ce484222325ull ^ (seed * 0x9e3779b97f4a7c15ull);
+    for (char c : word) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100000001b3ull;
+    }
+    h ^= h >> 32;
+    h *= 0xd6e8feb86659fd93ull;
+    h ^= h >> 32;
+    return h;
+}
+
+/**
+ * @brief Hash-and-displace table: each bucket stores the seed that sends its words
+ * to distinct free slots, and each slot stores the index of its word (or -1)
+ */
+struct Table {
+    std::array<uint16_t, kBucketCount> seeds{};
+    std::array<int16_t, kSlotCount> slots{};
+    bool complete = false;
+};
+
+constexpr Table build() {
+    Table table;
+    for (auto& slot : table.slots) {
+        slot = -1;
+    }
+
+    std::array<size_t, kBucketCount> bucketSizes{};
+    size_t largest = 0;
+    for (size_t i = 0; i < kWordCount; ++i) {
+        size_t size = ++bucketSizes[hash(kDefaultWords[i], 0) & (kBucketCount - 1)];
+        largest = size > largest ? size : largest;
+    }
+
+    // Place the most crowded buckets first, while the slot array is still sparse
+    for (size_t size = largest; size > 0; --size) {
+        for (size_t bucket = 0; bucket < kBucketCount; ++bucket) {
+            if (bucketSizes[bucket] != size) {
+                continue;
+            }
+
+            bool placed = false;
+            for (uint32_t seed = 1; seed <= 0xFFFF && !placed; ++seed) {
+                placed = true;
+                for (size_t i = 0; i < kWordCount && placed; ++i) {
+                    if ((hash(kDefaultWords[i], 0) & (kBucketCount - 1)) != bucket) {
+                        continue;
+                    }
+                    auto& slot = table.slots[hash(kDefaultWords[i], seed) & (kSlotCount - 1)];
+                    if (slot == -1) {
+                        slot = static_cast<int16_t>(i);
+                    }
+                    else {
+                        placed = false;
+                    }
+                }
+
+                if (placed) {
+                    table.seeds[bucket] = static_cast<uint16_t>(seed);
+                }
+                else {
+                    // Undo this attempt's placements
+                    for (auto& slot : table.slots) {
+                        if (slot >= 0 && (hash(kDefaultWords[slot], 0) & (kBucketCount - 1)) == bucket) {
+                            slot = -1;
+                        }
+                    }
+                }
+            }
+
+            if (!placed) {
+                return table;
+            }
+        }
+    }
+
+    table.complete = true;
+    return table;
+}
+
+inline constexpr Table kTable = build();
+static_assert(kTable.complete, "no perfect hash found for the default stopword list");
+
+/**
+ * @brief Membership test against the built-in list
+ */
+constexpr bool contains(std::string_view word) {
+    uint16_t seed = kTable.seeds[hash(word, 0) & (kBucketCount - 1)];
+    if (seed == 0) {
+        return false;
+    }
+    int16_t index = kTable.slots[hash(word, seed) & (kSlotCount - 1)];
+    return index >= 0 && kDefaultWords[index] == word;
+}
+
+constexpr bool containsAllDefaults() {
+    for (auto word : kDefaultWords) {
+        if (!contains(word)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(containsAllDefaults(), "perfect hash table lost a stopword");
+
+} // namespace stopword_table
+
+/**
+ * @brief Stopwords shared by document parsing and query processing
+ *
+ * By default lookups go to the built-in table generated from stopwords.txt, which
+ * needs no file at run time and never allocates. Loading a file replaces the
+ * built-in list for this set.
+ */
+class StopwordSet {
+private:
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    std::unordered_set<std::string, StringHash, std::equal_to<>> overrideWords;
+    bool useOverride = false;
+
+public:
+    /**
+     * @brief Constructor using the built-in list
+     */
+    StopwordSet() = default;
+
+    /**
+     * @brief Constructor
+     * @param filename Whitespace-separated stopwords file; empty for the built-in list
+     */
+    explicit StopwordSet(const std::string& filename);
+
+    /**
+     * @brief Replace the active list with the words in a file
+     * @param filename Whitespace-separated stopwords file
+     * @return false (keeping the current list) if the file could not be opened
+     */
+    bool loadFile(const std::string& filename);
+
+    /**
+     * @brief Check whether a normalized token is a stopword
+     * @param word Lowercased token
+     * @return true if word is a stopword
+     */
+    bool contains(std::string_view word) const {
+        return useOverride ? overrideWords.find(word) != overrideWords.end()
+                           : stopword_table::contains(word);
+    }
+
+    /**
+     * @brief Number of stopwords in the active list
+     */
+    size_t size() const {
+        return useOverride ? overrideWords.size() : stopword_table::kWordCount;
+    }
+};
@@ -0,0 +1,59 @@
+/**
+ * @file TermTrie.h
+ * @author <YourName>
+ * @brief Compact trie over a sorted term dictionary for approximate lookup
+ * @version 1.0
+ * @date 2024-03-15
+ *
+ * History:
+ * - 2024-03-15: Initial implementation
+ */
+
+#pragma once
+#include "LevenshteinAutomaton.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Trie of a word list, stored as flat arrays in preorder
+ *
+ * A node's subtree occupies the nodes up to its subtreeEnd, so its first child
+ * (if any) is the next node and each child's subtreeEnd is the following
+ * sibling. A node needs that index, its edge byte and whether a word ends
+ * there (six bytes), and it is built in one pass over the sorted words.
+ * Intersecting it with an automaton follows one edge per step instead of
+ * searching the dictionary for each next character.
+ */
+class TermTrie {
+public:
+    /**
+     * @brief Replace the contents with a word list
+     * @param words Distinct, non-empty words in ascending order
+     */
+    void build(const std::vector<std::string_view>& words);
+    
+    /**
+     * @brief Words accepted by an automaton, visiting only prefixes it can still accept
+     * @param automaton Levenshtein automaton of the query term
+     * @return Each accepted word with its edit distance, in word order
+     */
+    std::vector<std::pair<std::string, uint32_t>> match(LevenshteinAutomaton& automaton) const;
+    
+    /**
+     * @brief Remove all words
+     */
+    void clear();
+    
+    /**
+     * @brief Number of nodes, including the root
+     */
+    size_t nodeCount() const { return labels.size(); }
+
+private:
+    std::vector<uint32_t> subtreeEnd;  // node -> one past the last node of its subtree
+    std::vector<uint8_t> labels;       // node -> byte on the edge from its parent
+    std::vector<uint8_t> terminal;     // node -> 1 if a word ends here
+};
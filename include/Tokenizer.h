@@ -0,0 +1,62 @@
+/**
+ * @file Tokenizer.h
+ * @author <YourName>
+ * @brief Allocation-free tokenizer shared by indexing and query parsing
+ * @version 1.0
+ * @date 2024-03-15
+ *
+ * History:
+ * - 2024-03-15: Initial implementation
+ */
+
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Splits text into lowercase, punctuation-free tokens
+ *
+ * Tokens are separated by whitespace; ASCII letters are lowercased and ASCII
+ * punctuation is dropped, matching std::isspace/std::tolower/std::ispunct in the
+ * "C" locale. Bytes are classified 16 (SSE2) or 32 (AVX2) at a time, and the
+ * normalized tokens are written into a scratch buffer owned by the tokenizer, so
+ * tokenizing performs no allocation once the buffer has grown to the input size.
+ *
+ * Text is UTF-8. A block whose bytes are all ASCII is valid by construction and
+ * takes the vector path; a block containing other bytes is decoded one code
+ * point at a time. Letters there get Unicode simple case folding ("SOCIÉTÉ" and
+ * "société" give the same token), Unicode spaces split tokens, punctuation and
+ * currency symbols are dropped, and malformed bytes are skipped, so tokens are
+ * always valid UTF-8.
+ */
+class Tokenizer {
+private:
+    std::string scratch;
+    std::vector<std::string_view> tokens;
+
+public:
+    Tokenizer() = default;
+
+    /**
+     * @brief Tokenize text
+     * @param text Input text
+     * @return Normalized tokens, valid until the next call to tokenize
+     */
+    const std::vector<std::string_view>& tokenize(std::string_view text);
+
+    /**
+     * @brief Normalize a single whitespace-free word
+     * @param word Raw word (e.g. a query term)
+     * @return Lowercased word with punctuation removed, possibly empty
+     */
+    std::string normalize(std::string_view word);
+
+    /**
+     * @brief Fold the case of letters the way tokens are folded, keeping everything else
+     * @param text UTF-8 text (e.g. an entity name)
+     * @return Text with ASCII letters lowercased and other letters case folded;
+     *         spaces, punctuation and malformed bytes are copied unchanged
+     */
+    static std::string foldCase(std::string_view text);
+};
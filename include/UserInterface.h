@@ -13,13 +13,17 @@
 #include "IndexHandler.h"
 #include "DocumentParser.h"
 #include "QueryProcessor.h"
+#include "StopwordSet.h"
 #include <string>
 
 class UserInterface {
 private:
     IndexHandler indexHandler;
+    StopwordSet stopwords;
     DocumentParser documentParser;
     QueryProcessor queryProcessor;
+    QueryCache queryCache;    // repeated queries in interactive mode
+    size_t memoryBudget = 0;  // word posting bytes for the index command (0 = unlimited)
     
     /**
      * @brief Display search results
@@ -27,6 +31,13 @@ private:
      */
     void displayResults(const std::vector<QueryResult>& results) const;
     
+    /**
+     * @brief Run a search and display its results with any note about the index
+     * @param query User query string
+     * @return The results shown
+     */
+    std::vector<QueryResult> runQuery(const std::string& query);
+    
     /**
      * @brief Display full article
      * @param docID Document ID
@@ -49,13 +60,19 @@ private:
      * @brief Run interactive UI
      */
     void handleUICommand();
-    
+
 public:
     /**
      * @brief Constructor
-     * @param stopwordsFile Path to stopwords file
+     * @param stopwordsFile Path to stopwords file, or empty for the built-in list
+     * @param aliasesFile Path to entity alias file, or empty for none
+     * @param storePositions Record token positions when indexing (enables phrase queries)
+     * @param memoryBudget Bytes of word postings the index command keeps in memory
+     *                     before spilling to run files, or 0 for no limit
+     * @param detectDuplicates Collapse near-duplicate articles when indexing
      */
-    UserInterface(const std::string& stopwordsFile);
+    UserInterface(const std::string& stopwordsFile, const std::string& aliasesFile = "",
+                  bool storePositions = false, size_t memoryBudget = 0, bool detectDuplicates = false);
     
     /**
      * @brief Process command line arguments
@@ -5,242 +5,1051 @@
  */
 
 #include "../include/DocumentParser.h"
-#include "../thirdparty/rapidjson/include/rapidjson/document.h"
+#include "../include/Tokenizer.h"
+#include "../include/StemCache.h"
+#include "../include/SimHash.h"
+#include "../thirdparty/rapidjson/include/rapidjson/reader.h"
 #include "../thirdparty/rapidjson/include/rapidjson/error/en.h"
-#include "../thirdparty/porter2_stemmer/thirdparty/porter2_stemmer/porter2_stemmer.h"
 #include <iostream>
 #include <fstream>
-#include <sstream>
-#include <algorithm>
 #include <filesystem>
-#include <cctype>
 #include <iomanip>
+#include <iterator>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cctype>
+#include <cstring>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+/**
+ * @brief The article fields the index uses, as views into the parse buffer
+ * 
+ * A view with a null data pointer means the field was absent (or not a string).
+ */
+struct ArticleFields {
+    std::string_view uuid;
+    std::string_view title;
+    std::string_view date;
+    std::string_view source;
+    std::string_view content;
+    std::vector<std::string_view> organizations;
+    std::vector<std::string_view> persons;
+    
+    void clear() {
+        uuid = title = date = source = content = std::string_view();
+        organizations.clear();
+        persons.clear();
+    }
+};
+
+/**
+ * @brief SAX handler that picks the indexed fields out of an article
+ * 
+ * Only uuid, title, date_publish, source, content and metadata.organizations /
+ * metadata.persons are kept. Every other value (entities, thread, ...) streams
+ * past without being materialized.
+ */
+class ArticleHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, ArticleHandler> {
+public:
+    explicit ArticleHandler(ArticleFields& fields) : fields(fields) {}
+    
+    bool Key(const char* str, rapidjson::SizeType length, bool) {
+        std::string_view key(str, length);
+        pending = Field::None;
+        
+        if (depth == 1) {
+            if (key == "uuid") pending = Field::UUID;
+            else if (key == "title") pending = Field::Title;
+            else if (key == "date_publish") pending = Field::Date;
+            else if (key == "source") pending = Field::Source;
+            else if (key == "content") pending = Field::Content;
+            else if (key == "metadata") pending = Field::Metadata;
+        }
+        else if (depth == 2 && inMetadata) {
+            if (key == "organizations") pending = Field::Organizations;
+            else if (key == "persons") pending = Field::Persons;
+        }
+        return true;
+    }
+    
+    bool String(const char* str, rapidjson::SizeType length, bool) {
+        std::string_view value(str, length);
+        
+        if (collecting != Field::None && depth == collectDepth) {
+            (collecting == Field::Organizations ? fields.organizations : fields.persons).push_back(value);
+            return true;
+        }
+        
+        switch (pending) {
+            case Field::UUID:    fields.uuid = value; break;
+            case Field::Title:   fields.title = value; break;
+            case Field::Date:    fields.date = value; break;
+            case Field::Source:  fields.source = value; break;
+            case Field::Content: fields.content = value; break;
+            default: break;
+        }
+        pending = Field::None;
+        return true;
+    }
+    
+    bool StartObject() {
+        ++depth;
+        if (depth == 2 && pending == Field::Metadata) {
+            inMetadata = true;
+        }
+        pending = Field::None;
+        return true;
+    }
+    
+    bool EndObject(rapidjson::SizeType) {
+        if (depth == 2) {
+            inMetadata = false;
+        }
+        --depth;
+        pending = Field::None;
+        return true;
+    }
+    
+    bool StartArray() {
+        ++depth;
+        if (pending == Field::Organizations || pending == Field::Persons) {
+            collecting = pending;
+            collectDepth = depth;
+        }
+        pending = Field::None;
+        return true;
+    }
+    
+    bool EndArray(rapidjson::SizeType) {
+        if (depth == collectDepth) {
+            collecting = Field::None;
+            collectDepth = 0;
+        }
+        --depth;
+        pending = Field::None;
+        return true;
+    }
+    
+    // Numbers, booleans and nulls are never indexed
+    bool Default() {
+        pending = Field::None;
+        return true;
+    }
+
+private:
+    enum class Field { None, UUID, Title, Date, Source, Content, Metadata, Organizations, Persons };
+    
+    ArticleFields& fields;
+    int depth = 0;
+    int collectDepth = 0;
+    bool inMetadata = false;
+    Field pending = Field::None;
+    Field collecting = Field::None;
+};
+
+/**
+ * @brief Per-thread buffers reused across articles
+ * 
+ * The file bytes are parsed in place and the extracted fields point into them,
+ * so a typical article parses without touching the heap.
+ */
+struct ParseScratch {
+    std::vector<char> fileBuffer;
+    std::vector<char> streamBuffer;
+    rapidjson::Reader reader;
+    ArticleFields fields;
+    Tokenizer tokenizer;
+    std::unordered_map<std::string, uint32_t> termSlots;            // term -> index in terms
+    std::vector<std::pair<uint32_t, uint32_t>> occurrences;         // (term index, position)
+    std::vector<uint64_t> termHashes;                               // term index -> SimHash::hash
+    std::unordered_set<uint64_t> pairHashes;                        // consecutive term pairs seen
+    SimHash simhash;
+};
+
+thread_local ParseScratch parseScratch;
+
+/**
+ * @brief One article file found by the directory scan
+ */
+struct ScannedFile {
+    std::string path;
+    std::string relative;       // path below the indexed directory, as recorded in the manifest
+    uint64_t size = 0;
+    int64_t modified = 0;
+    uint64_t hash = 0;          // content hash, if the file had to be read to compare it
+    bool changed = true;        // new or modified since the manifest was saved
+};
 
-DocumentParser::DocumentParser(IndexHandler& handler, const std::string& stopwordsFile)
-    : indexHandler(handler) {
-    loadStopwords(stopwordsFile);
+/**
+ * @brief List the .json files below each month directory, in indexing order
+ *
+ * Month directories are walked on parallel threads. With a manifest each file
+ * is also stat'ed and compared with its entry; a file whose size or modification
+ * time differs is read and hashed there, so a touched but unmodified file does
+ * not count as changed.
+ *
+ * @return Files of each month directory, in the order of monthDirs
+ */
+std::vector<std::vector<ScannedFile>> scanMonths(const std::vector<std::filesystem::path>& monthDirs,
+                                                 const std::filesystem::path& root, const Manifest* manifest) {
+    std::vector<std::vector<ScannedFile>> months(monthDirs.size());
+    std::atomic<size_t> nextMonth{0};
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    
+    auto scan = [&] {
+        std::string content;
+        for (size_t month = nextMonth++; month < monthDirs.size(); month = nextMonth++) {
+            try {
+                for (const auto& entry : std::filesystem::recursive_directory_iterator(monthDirs[month])) {
+                    if (!entry.is_regular_file() || entry.path().extension() != ".json") {
+                        continue;
+                    }
+                    ScannedFile file;
+                    file.path = entry.path().string();
+                    if (manifest) {
+                        file.relative = entry.path().lexically_relative(root).generic_string();
+                        file.size = entry.file_size();
+                        file.modified = entry.last_write_time().time_since_epoch().count();
+                        
+                        const Manifest::Entry* known = manifest->find(file.relative);
+                        if (known && known->size == file.size && known->modified == file.modified) {
+                            file.changed = false;
+                        }
+                        else if (known && known->size == file.size) {
+                            std::ifstream in(file.path, std::ios::binary);
+                            content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+                            file.hash = Manifest::hashContent(content);
+                            file.changed = !in.is_open() || file.hash != known->hash;
+                        }
+                    }
+                    months[month].push_back(std::move(file));
+                }
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                error = std::current_exception();
+            }
+        }
+    };
+    
+    unsigned hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < std::min<size_t>(hardwareThreads, monthDirs.size()); ++i) {
+        threads.emplace_back(scan);
+    }
+    scan();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return months;
 }
 
-void DocumentParser::loadStopwords(const std::string& filename) {
-    std::ifstream file(filename);
+// Read size for sequential archive ingestion
+constexpr size_t kStreamChunkSize = 4 << 20;
+constexpr size_t kTarBlockSize = 512;
+
+// Directory files read ahead of the index insertion point (see FileReader::kMaxReadAhead)
+constexpr size_t kIngestWindow = 2 * FileReader::kMaxReadAhead;
+
+/**
+ * @brief Parse a numeric tar header field (octal, or GNU base-256 for large sizes)
+ */
+uint64_t tarNumber(const char* field, size_t length) {
+    if (static_cast<unsigned char>(field[0]) & 0x80) {
+        uint64_t value = static_cast<unsigned char>(field[0]) & 0x7F;
+        for (size_t i = 1; i < length; ++i) {
+            value = (value << 8) | static_cast<unsigned char>(field[i]);
+        }
+        return value;
+    }
+    
+    uint64_t value = 0;
+    for (size_t i = 0; i < length && field[i]; ++i) {
+        if (field[i] >= '0' && field[i] <= '7') {
+            value = value * 8 + static_cast<uint64_t>(field[i] - '0');
+        }
+    }
+    return value;
+}
+
+/**
+ * @brief Verify a ustar header checksum (sum of header bytes, checksum field as spaces)
+ */
+bool tarChecksumValid(const char* header) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < kTarBlockSize; ++i) {
+        sum += (i >= 148 && i < 156) ? ' ' : static_cast<unsigned char>(header[i]);
+    }
+    return sum == tarNumber(header + 148, 8);
+}
+
+/**
+ * @brief Extract the path= record from a pax extended header, if present
+ */
+std::string paxPath(std::string_view records) {
+    // Records are "<length> <key>=<value>\n"
+    while (!records.empty()) {
+        size_t space = records.find(' ');
+        if (space == std::string_view::npos) break;
+        
+        size_t length = 0;
+        for (char c : records.substr(0, space)) {
+            length = length * 10 + static_cast<size_t>(c - '0');
+        }
+        if (length <= space || length > records.size()) break;
+        
+        std::string_view record = records.substr(space + 1, length - space - 2);
+        if (record.substr(0, 5) == "path=") {
+            return std::string(record.substr(5));
+        }
+        records.remove_prefix(length);
+    }
+    return "";
+}
+
+bool hasJSONExtension(std::string_view name) {
+    return name.size() >= 5 && name.substr(name.size() - 5) == ".json";
+}
+
+bool isBlank(const char* line) {
+    for (; *line; ++line) {
+        if (!std::isspace(static_cast<unsigned char>(*line))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void printStreamProgress(size_t processed, size_t errors) {
+    std::cout << "\rProgress: " << processed << " articles - Errors: " << errors << std::flush;
+}
+
+void printStreamSummary(size_t processed, size_t errors) {
+    std::cout << "\n\nIndexing complete:\n"
+              << "- Processed: " << processed << " articles\n"
+              << "- Successful: " << (processed - errors) << " articles\n"
+              << "- Errors: " << errors << " articles\n";
+}
+
+/**
+ * @brief Read a whole file into buffer, NUL-terminated for in-situ parsing
+ */
+void readFile(const std::string& filename, std::vector<char>& buffer) {
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
     if (!file) {
-        std::cerr << "Warning: Could not open stopwords file: " << filename << std::endl;
-        // Add some common stopwords as fallback
-        stopwords = {"a", "an", "the", "and", "or", "but", "is", "are", "in", "to", "of", "for"};
-        return;
+        throw std::runtime_error("Failed to open file: " + filename);
     }
     
-    std::string word;
-    while (file >> word) {
-        stopwords.insert(word);
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    
+    buffer.resize(static_cast<size_t>(size) + 1);
+    if (!file.read(buffer.data(), size)) {
+        throw std::runtime_error("Failed to read file: " + filename);
     }
+    buffer[static_cast<size_t>(size)] = '\0';
+}
+
+/**
+ * @brief Field value, or fallback if the field was absent
+ */
+std::string_view fieldOr(std::string_view field, std::string_view fallback) {
+    return field.data() ? field : fallback;
+}
+
+} // namespace
+
+DocumentParser::DocumentParser(IndexHandler& handler, const StopwordSet& stopwords)
+    : indexHandler(handler), stopwords(stopwords), fileReader(FileReader::create()) {
 }
 
 void DocumentParser::parseJSON(const std::string& filename) {
     try {
-        std::ifstream file(filename);
-        if (!file) {
-            throw std::runtime_error("Failed to open file: " + filename);
+        readFile(filename, parseScratch.fileBuffer);
+        parseArticle(parseScratch.fileBuffer.data());
+    }
+    catch (const std::exception& e) {
+        throw std::runtime_error("Error processing " + filename + ": " + e.what());
+    }
+}
+
+void DocumentParser::parseArticle(char* json) {
+    analyzeArticle(json, articleScratch, true);
+    indexArticle(articleScratch);
+}
+
+void DocumentParser::analyzeArticle(char* json, AnalyzedArticle& article, bool checkIndexed) const {
+    ParseScratch& scratch = parseScratch;
+    ArticleFields& fields = scratch.fields;
+    fields.clear();
+    
+    ArticleHandler handler(fields);
+    rapidjson::InsituStringStream stream(json);
+    rapidjson::ParseResult result = 
+        scratch.reader.Parse<rapidjson::kParseInsituFlag>(stream, handler);
+    
+    if (!result) {
+        throw std::runtime_error("JSON parse error: " + 
+                                std::string(rapidjson::GetParseError_En(result.Code())) + 
+                                " at offset " + std::to_string(result.Offset()));
+    }
+    
+    // Extract document ID
+    if (!fields.uuid.data()) {
+        throw std::runtime_error("Missing or invalid uuid field");
+    }
+    article.uuid.assign(fields.uuid);
+    article.terms.clear();
+    article.length = 0;
+    article.fingerprint = 0;
+    article.organizations.clear();
+    article.persons.clear();
+    
+    // Articles already in the index (e.g. re-indexing the same files) are skipped
+    article.alreadyIndexed = checkIndexed && indexHandler.hasDocument(article.uuid);
+    article.hasContent = fields.content.data() != nullptr;
+    if (article.alreadyIndexed || !article.hasContent) {
+        return;
+    }
+    
+    // Extract metadata for display
+    article.title.assign(fieldOr(fields.title, "Untitled"));
+    article.published = DocumentStore::parseDate(fields.date);
+    article.source.assign(fieldOr(fields.source, "Unknown Source"));
+    
+    // Process content (tokenize, remove stopwords, stem)
+    processContent(fields.content, article);
+    
+    // Entities
+    for (std::string_view org : fields.organizations) {
+        article.organizations.emplace_back(org);
+    }
+    for (std::string_view person : fields.persons) {
+        article.persons.emplace_back(person);
+    }
+}
+
+uint32_t DocumentParser::indexArticle(const AnalyzedArticle& article) {
+    if (article.alreadyIndexed || indexHandler.hasDocument(article.uuid)) {
+        return indexHandler.findDocument(article.uuid);
+    }
+    
+    if (!article.hasContent) {
+        throw std::runtime_error("Missing or invalid content field");
+    }
+    
+    // A near-duplicate (typically the same wire story under another uuid) is
+    // collapsed into the first copy instead of being indexed again
+    uint32_t canonical = indexHandler.findNearDuplicate(article.fingerprint);
+    if (canonical != SimHashIndex::kNotFound) {
+        indexHandler.addDuplicate(article.uuid, canonical);
+        return canonical;
+    }
+    
+    // Add document to index
+    uint32_t doc = indexHandler.registerDocument(article.uuid);
+    indexHandler.setDocumentFingerprint(doc, article.fingerprint);
+    indexHandler.addDocumentMetadata(doc, article.title, article.published, article.source);
+    
+    // Record raw counts; scoring happens at query time
+    indexHandler.setDocumentLength(doc, article.length);
+    const uint32_t* positions = article.positions.data();
+    for (const auto& [term, count] : article.terms) {
+        if (article.hasPositions) {
+            indexHandler.addTermPositions(term, doc, positions, count);
+            positions += count;
         }
-        
-        std::string json((std::istreambuf_iterator<char>(file)), 
-                         std::istreambuf_iterator<char>());
-        
-        rapidjson::Document doc;
-        rapidjson::ParseResult result = doc.Parse(json.c_str());
-        
-        if (!result) {
-            throw std::runtime_error("JSON parse error: " + 
-                                    std::string(rapidjson::GetParseError_En(result.Code())) + 
-                                    " at offset " + std::to_string(result.Offset()));
+        else {
+            indexHandler.addTerm(term, doc, count);
         }
-        
-        // Extract document ID
-        if (!doc.HasMember("uuid") || !doc["uuid"].IsString()) {
-            throw std::runtime_error("Missing or invalid uuid field");
+    }
+    
+    for (const auto& [first, second] : article.bigrams) {
+        indexHandler.countBigram(article.terms[first].first, article.terms[second].first, 1);
+    }
+    
+    for (const auto& org : article.organizations) {
+        indexHandler.addOrganization(org, doc);
+    }
+    
+    for (const auto& person : article.persons) {
+        indexHandler.addPerson(person, doc);
+    }
+    
+    return doc;
+}
+
+void DocumentParser::parseJSONLines(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+    
+    std::vector<char>& buffer = parseScratch.streamBuffer;
+    if (buffer.size() < kStreamChunkSize + 1) {
+        buffer.resize(kStreamChunkSize + 1);
+    }
+    
+    size_t filled = 0;
+    size_t lineNumber = 0;
+    size_t processed = 0;
+    size_t errorCount = 0;
+    
+    auto parseLine = [&](char* line) {
+        ++lineNumber;
+        if (isBlank(line)) {
+            return;
         }
-        std::string docID = doc["uuid"].GetString();
         
-        // Extract document content
-        if (!doc.HasMember("content") || !doc["content"].IsString()) {
-            throw std::runtime_error("Missing or invalid content field");
+        try {
+            parseArticle(line);
+        }
+        catch (const std::exception& e) {
+            errorCount++;
+            std::cerr << "\nError in " << filename << " line " << lineNumber 
+                      << ": " << e.what() << std::endl;
         }
-        std::string content = doc["content"].GetString();
         
-        // Extract metadata for display
-        std::string title = doc.HasMember("title") && doc["title"].IsString() ? 
-                            doc["title"].GetString() : "Untitled";
-                            
-        std::string date = doc.HasMember("date_publish") && doc["date_publish"].IsString() ? 
-                          doc["date_publish"].GetString() : "Unknown Date";
-                          
-        std::string source = doc.HasMember("source") && doc["source"].IsString() ? 
-                            doc["source"].GetString() : "Unknown Source";
+        if (++processed % 1000 == 0) {
+            printStreamProgress(processed, errorCount);
+        }
+    };
+    
+    std::cout << "Streaming articles from " << filename << "...\n";
+    
+    while (true) {
+        // A single line longer than the buffer: grow it
+        if (filled == buffer.size() - 1) {
+            buffer.resize(buffer.size() * 2);
+        }
         
-        // Add document to index
-        indexHandler.registerDocument(docID);
-        indexHandler.addDocumentMetadata(docID, title, date, source);
+        file.read(buffer.data() + filled, static_cast<std::streamsize>(buffer.size() - 1 - filled));
+        size_t got = static_cast<size_t>(file.gcount());
+        filled += got;
         
-        // Process content (tokenize, remove stopwords, stem)
-        processContent(content, docID);
+        // Parse every complete line in place
+        size_t start = 0;
+        while (start < filled) {
+            char* newline = static_cast<char*>(std::memchr(buffer.data() + start, '\n', filled - start));
+            if (!newline) break;
+            
+            *newline = '\0';
+            parseLine(buffer.data() + start);
+            start = static_cast<size_t>(newline - buffer.data()) + 1;
+        }
         
-        // Process entities if available
-        if (doc.HasMember("metadata") && doc["metadata"].IsObject()) {
-            processEntities(doc["metadata"], docID);
+        if (got == 0) {
+            // Final line without a trailing newline
+            if (start < filled) {
+                buffer[filled] = '\0';
+                parseLine(buffer.data() + start);
+            }
+            break;
         }
+        
+        // Keep the partial last line for the next read
+        std::memmove(buffer.data(), buffer.data() + start, filled - start);
+        filled -= start;
     }
-    catch (const std::exception& e) {
-        throw std::runtime_error("Error processing " + filename + ": " + e.what());
-    }
+    
+    printStreamSummary(processed, errorCount);
 }
 
-void DocumentParser::processContent(const std::string& content, const std::string& docID) {
-    std::istringstream iss(content);
-    std::string token;
-    std::unordered_map<std::string, int> termFrequency;
+void DocumentParser::parseTar(const std::string& filename) {
+    // Large stream buffer so entries are read with few sequential syscalls
+    std::vector<char>& streamBuffer = parseScratch.streamBuffer;
+    if (streamBuffer.size() < kStreamChunkSize) {
+        streamBuffer.resize(kStreamChunkSize);
+    }
+    
+    std::ifstream file;
+    file.rdbuf()->pubsetbuf(streamBuffer.data(), static_cast<std::streamsize>(streamBuffer.size()));
+    file.open(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+    
+    std::vector<char>& article = parseScratch.fileBuffer;
+    char header[kTarBlockSize];
+    std::string longName;
+    size_t processed = 0;
+    size_t errorCount = 0;
     
-    // Tokenize and process
-    while (iss >> token) {
-        // Convert to lowercase
-        std::transform(token.begin(), token.end(), token.begin(),
-                      [](unsigned char c) { return std::tolower(c); });
+    std::cout << "Streaming articles from " << filename << "...\n";
+    
+    while (file.read(header, kTarBlockSize)) {
+        // End of archive is marked by zero blocks
+        if (std::all_of(header, header + kTarBlockSize, [](char c) { return c == 0; })) {
+            break;
+        }
         
-        // Remove punctuation
-        token.erase(std::remove_if(token.begin(), token.end(), 
-                                 [](unsigned char c) { return std::ispunct(c); }),
-                   token.end());
+        if (!tarChecksumValid(header)) {
+            if (processed == 0 && static_cast<unsigned char>(header[0]) == 0x1F && 
+                static_cast<unsigned char>(header[1]) == 0x8B) {
+                throw std::runtime_error("Compressed archives are not supported, decompress first: " + filename);
+            }
+            throw std::runtime_error("Invalid tar header in " + filename);
+        }
         
-        // Skip empty tokens or stopwords
-        if (token.empty() || stopwords.count(token) > 0) {
+        uint64_t size = tarNumber(header + 124, 12);
+        uint64_t padded = (size + kTarBlockSize - 1) / kTarBlockSize * kTarBlockSize;
+        char type = header[156];
+        
+        // Entry name: a preceding GNU long name or pax path wins over the header fields
+        std::string name;
+        if (!longName.empty()) {
+            name.swap(longName);
+        }
+        else {
+            std::string_view prefix(header + 345, strnlen(header + 345, 155));
+            std::string_view base(header, strnlen(header, 100));
+            name = prefix.empty() ? std::string(base) : std::string(prefix) + "/" + std::string(base);
+        }
+        
+        bool metadataEntry = type == 'L' || type == 'x';
+        bool wanted = metadataEntry || ((type == '0' || type == '\0') && hasJSONExtension(name));
+        
+        if (!wanted) {
+            file.ignore(static_cast<std::streamsize>(padded));
             continue;
         }
         
-        // Apply Porter stemming
-        Porter2Stemmer::stem(token);
+        article.resize(size + 1);
+        if (!file.read(article.data(), static_cast<std::streamsize>(size))) {
+            throw std::runtime_error("Truncated tar entry " + name + " in " + filename);
+        }
+        article[size] = '\0';
+        file.ignore(static_cast<std::streamsize>(padded - size));
         
-        // Count term frequency
-        termFrequency[token]++;
+        if (type == 'L') {
+            longName.assign(article.data(), strnlen(article.data(), size));
+            continue;
+        }
+        if (type == 'x') {
+            longName = paxPath(std::string_view(article.data(), size));
+            continue;
+        }
+        
+        try {
+            parseArticle(article.data());
+        }
+        catch (const std::exception& e) {
+            errorCount++;
+            std::cerr << "\nError in " << name << ": " << e.what() << std::endl;
+        }
+        
+        if (++processed % 1000 == 0) {
+            printStreamProgress(processed, errorCount);
+        }
     }
     
-    // Calculate term frequency and add to index
-    size_t totalTerms = 0;
-    for (const auto& [term, count] : termFrequency) {
-        totalTerms += count;
+    printStreamSummary(processed, errorCount);
+}
+
+void DocumentParser::parsePath(const std::string& path, Manifest* manifest) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    size_t duplicatesBefore = indexHandler.getDuplicateCount();
+    
+    if (std::filesystem::is_directory(path)) {
+        parseDirectory(path, manifest);
+    }
+    else if (extension == ".jsonl" || extension == ".ndjson") {
+        parseJSONLines(path);
+    }
+    else if (extension == ".tar") {
+        parseTar(path);
+    }
+    else {
+        parseJSON(path);
     }
     
-    for (const auto& [term, count] : termFrequency) {
-        // Add initial term frequency (TF)
-        double tf = static_cast<double>(count) / totalTerms;
-        indexHandler.addTerm(term, docID, tf);
+    if (indexHandler.detectsDuplicates()) {
+        std::cout << "- Near-duplicates collapsed: " 
+                  << indexHandler.getDuplicateCount() - duplicatesBefore << " articles\n";
     }
+    
+    // Frequent bigrams are chosen over the whole collection once the input is in
+    indexHandler.buildBigramIndex();
+    indexHandler.buildScoreBounds();
+    indexHandler.buildWordTrie();
 }
 
-void DocumentParser::processEntities(const rapidjson::Value& metadata, const std::string& docID) {
-    // Process organizations
-    if (metadata.HasMember("organizations") && metadata["organizations"].IsArray()) {
-        for (const auto& org : metadata["organizations"].GetArray()) {
-            if (org.IsString()) {
-                indexHandler.addOrganization(org.GetString(), docID);
+void DocumentParser::processContent(std::string_view content, AnalyzedArticle& article) const {
+    ParseScratch& scratch = parseScratch;
+    std::string term;
+    std::unordered_map<std::string, uint32_t>& termSlots = scratch.termSlots;
+    std::vector<std::pair<uint32_t, uint32_t>>& occurrences = scratch.occurrences;
+    termSlots.clear();
+    occurrences.clear();
+    article.hasPositions = indexHandler.storesPositions();
+    article.positions.clear();
+    article.bigrams.clear();
+    bool collectBigrams = indexHandler.collectsBigrams();
+    uint32_t previousSlot = 0;
+    uint32_t previousPosition = UINT32_MAX;
+    
+    // SimHash over the distinct terms and distinct pairs of consecutive terms
+    // (stopwords dropped): a copy with a few words changed keeps nearly all of
+    // its features, and the pairs tell apart texts that merely share vocabulary
+    bool fingerprintContent = indexHandler.detectsDuplicates();
+    std::vector<uint64_t>& termHashes = scratch.termHashes;
+    std::unordered_set<uint64_t>& pairHashes = scratch.pairHashes;
+    SimHash& simhash = scratch.simhash;
+    termHashes.clear();
+    pairHashes.clear();
+    simhash.clear();
+    uint64_t previousHash = 0;
+    
+    // Tokenize (lowercased, punctuation stripped) into the per-thread scratch buffer.
+    // Positions count every token, stopwords included, so phrase offsets match.
+    const auto& tokens = scratch.tokenizer.tokenize(content);
+    for (uint32_t position = 0; position < tokens.size(); ++position) {
+        std::string_view token = tokens[position];
+        
+        // Skip stopwords
+        if (stopwords.contains(token)) {
+            continue;
+        }
+        
+        term.assign(token);
+        
+        // Apply Porter stemming (memoized)
+        StemCache::shared().stem(term);
+        
+        // Count term frequency
+        auto [slot, inserted] = termSlots.try_emplace(term, static_cast<uint32_t>(article.terms.size()));
+        if (inserted) {
+            article.terms.emplace_back(term, 0);
+            if (fingerprintContent) {
+                termHashes.push_back(SimHash::hash(term));
+                simhash.add(termHashes.back());
+            }
+        }
+        article.terms[slot->second].second++;
+        article.length++;
+        
+        if (article.hasPositions) {
+            occurrences.emplace_back(slot->second, position);
+        }
+        
+        // Candidate for the frequent-bigram index: two terms with no token between
+        if (collectBigrams && previousPosition + 1 == position) {
+            article.bigrams.emplace_back(previousSlot, slot->second);
+        }
+        previousSlot = slot->second;
+        previousPosition = position;
+        
+        if (fingerprintContent) {
+            uint64_t termHash = termHashes[slot->second];
+            if (article.length > 1) {
+                uint64_t pair = SimHash::combine(previousHash, termHash);
+                if (pairHashes.insert(pair).second) {
+                    simhash.add(pair);
+                }
             }
+            previousHash = termHash;
         }
     }
     
-    // Process persons
-    if (metadata.HasMember("persons") && metadata["persons"].IsArray()) {
-        for (const auto& person : metadata["persons"].GetArray()) {
-            if (person.IsString()) {
-                indexHandler.addPerson(person.GetString(), docID);
-            }
+    if (fingerprintContent) {
+        article.fingerprint = simhash.fingerprint();
+    }
+    
+    if (article.hasPositions) {
+        // Group positions by term; each group stays in ascending position order
+        std::vector<uint32_t> next(article.terms.size());
+        uint32_t offset = 0;
+        for (size_t i = 0; i < article.terms.size(); ++i) {
+            next[i] = offset;
+            offset += article.terms[i].second;
+        }
+        article.positions.resize(occurrences.size());
+        for (const auto& [slot, position] : occurrences) {
+            article.positions[next[slot]++] = position;
         }
     }
 }
 
-void DocumentParser::parseDirectory(const std::string& directory) {
+void DocumentParser::parseDirectory(const std::string& directory, Manifest* manifest) {
     try {
         if (!std::filesystem::exists(directory)) {
             throw std::runtime_error("Directory does not exist: " + directory);
         }
-
-        size_t totalFiles = 0;
+        
         size_t processedFiles = 0;
         size_t errorCount = 0;
-
-        // First, count total JSON files for progress reporting
+        ingestStats = IngestStats();
+        using Clock = std::chrono::steady_clock;
+        auto seconds = [](Clock::time_point start, Clock::time_point end) {
+            return std::chrono::duration<double>(end - start).count();
+        };
+        
+        // First, collect the JSON files in the order they will be indexed
+        auto scanStart = Clock::now();
         std::cout << "Scanning directories...\n";
+        std::vector<std::filesystem::path> monthDirs;
         for (const auto& monthDir : std::filesystem::directory_iterator(directory)) {
             if (monthDir.is_directory()) {
-                for (const auto& entry : std::filesystem::recursive_directory_iterator(monthDir)) {
-                    if (entry.is_regular_file() && entry.path().extension() == ".json") {
-                        totalFiles++;
+                monthDirs.push_back(monthDir.path());
+            }
+        }
+        std::vector<std::vector<ScannedFile>> scanned = scanMonths(monthDirs, directory, manifest);
+        
+        // With a manifest, tombstone the documents of changed and removed files
+        // and keep only new and changed files for parsing
+        size_t unchangedFiles = 0;
+        size_t removedFiles = 0;
+        if (manifest) {
+            std::unordered_set<std::string> present;
+            std::vector<uint32_t> deleted;
+            for (const auto& month : scanned) {
+                for (const auto& file : month) {
+                    present.insert(file.relative);
+                    const Manifest::Entry* known = manifest->find(file.relative);
+                    if (known && file.changed) {
+                        deleted.push_back(known->doc);
                     }
                 }
             }
+            std::vector<std::string> removed;
+            for (const auto& [relative, entry] : manifest->getEntries()) {
+                if (!present.count(relative)) {
+                    removed.push_back(relative);
+                    deleted.push_back(entry.doc);
+                }
+            }
+            for (const auto& relative : removed) {
+                manifest->erase(relative);
+            }
+            removedFiles = removed.size();
+            
+            // An unchanged file indexed as a deleted document (the same uuid, or a
+            // near-duplicate collapsed into it) has to be indexed again
+            std::unordered_set<uint32_t> deletedDocs(deleted.begin(), deleted.end());
+            for (auto& month : scanned) {
+                for (auto& file : month) {
+                    if (file.changed) {
+                        continue;
+                    }
+                    Manifest::Entry entry = *manifest->find(file.relative);
+                    if (deletedDocs.count(entry.doc)) {
+                        file.changed = true;
+                        continue;
+                    }
+                    if (entry.modified != file.modified) {
+                        entry.modified = file.modified;
+                        manifest->set(file.relative, entry);
+                    }
+                    unchangedFiles++;
+                }
+            }
+            indexHandler.deleteDocuments(deleted);
         }
-
+        
+        std::vector<std::string> paths;
+        std::vector<const ScannedFile*> pathFiles;
+        std::vector<std::pair<size_t, std::filesystem::path>> months;  // first file, month name
+        for (size_t month = 0; month < scanned.size(); ++month) {
+            months.emplace_back(paths.size(), monthDirs[month].filename());
+            for (const auto& file : scanned[month]) {
+                if (file.changed) {
+                    paths.push_back(file.path);
+                    pathFiles.push_back(&file);
+                }
+            }
+        }
+        size_t totalFiles = paths.size();
+        ingestStats.scanSeconds = seconds(scanStart, Clock::now());
+        
+        if (manifest) {
+            std::cout << "Unchanged since the last index: " << unchangedFiles << " files, removed: "
+                      << removedFiles << " files\n";
+        }
+        
+        unsigned hardwareThreads = std::thread::hardware_concurrency();
+        size_t workerCount = hardwareThreads > 2 ? hardwareThreads - 1 : 1;
+        
         std::cout << "Found " << totalFiles << " JSON files to process\n";
-        std::cout << "Starting indexing process...\n\n";
-
-        // Process each month's directory
-        for (const auto& monthDir : std::filesystem::directory_iterator(directory)) {
-            if (monthDir.is_directory()) {
-                std::cout << "\nProcessing " << monthDir.path().filename() << ":\n";
-                
-                // Process all JSON files in this month's directory
-                for (const auto& entry : std::filesystem::recursive_directory_iterator(monthDir)) {
-                    if (entry.is_regular_file() && entry.path().extension() == ".json") {
-                        try {
-                            parseJSON(entry.path().string());
-                            processedFiles++;
-                            
-                            // Show progress every 100 files
-                            if (processedFiles % 100 == 0) {
-                                float progress = (float)processedFiles / totalFiles * 100;
-                                std::cout << "\rProgress: " << processedFiles << "/" << totalFiles 
-                                        << " files (" << std::fixed << std::setprecision(1) 
-                                        << progress << "%) - Errors: " << errorCount 
-                                        << std::flush;
-                            }
+        std::cout << "Starting indexing process (" << fileReader->name() << " reads, " 
+                  << workerCount << " parser threads)...\n\n";
+        
+        // Reader thread -> files -> parser threads -> results -> this thread (index)
+        struct Result {
+            AnalyzedArticle article;
+            std::string error;
+            uint64_t hash = 0;  // content hash for the manifest
+        };
+        
+        std::mutex mutex;
+        std::condition_variable filesReady;
+        std::condition_variable resultsReady;
+        std::condition_variable windowOpen;
+        std::deque<FileReader::File> files;
+        std::unordered_map<size_t, Result> results;
+        size_t committed = 0;
+        bool readerDone = false;
+        bool stopping = false;
+        std::exception_ptr readerError;
+        
+        std::thread reader([&] {
+            try {
+                fileReader->readFiles(paths, [&](FileReader::File&& file) {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    // Bound memory: stay at most kIngestWindow files ahead of the index
+                    windowOpen.wait(lock, [&] { return stopping || file.index < committed + kIngestWindow; });
+                    if (!stopping) {
+                        files.push_back(std::move(file));
+                        filesReady.notify_one();
+                    }
+                });
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                readerError = std::current_exception();
+            }
+            
+            std::lock_guard<std::mutex> lock(mutex);
+            readerDone = true;
+            filesReady.notify_all();
+            resultsReady.notify_all();
+        });
+        
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < workerCount; ++i) {
+            workers.emplace_back([&] {
+                while (true) {
+                    FileReader::File file;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        filesReady.wait(lock, [&] { return !files.empty() || readerDone; });
+                        if (files.empty()) {
+                            return;
                         }
-                        catch (const std::exception& e) {
-                            errorCount++;
-                            std::cerr << "\nError in file " << entry.path().filename() 
-                                    << ": " << e.what() << std::endl;
+                        file = std::move(files.front());
+                        files.pop_front();
+                    }
+                    
+                    Result result;
+                    auto analyzeStart = Clock::now();
+                    try {
+                        if (file.error) {
+                            throw std::runtime_error("Failed to read file: " + std::string(std::strerror(file.error)));
                         }
+                        if (manifest) {
+                            result.hash = Manifest::hashContent(std::string_view(file.data.data(), file.data.size() - 1));
+                        }
+                        analyzeArticle(file.data.data(), result.article, false);
+                    }
+                    catch (const std::exception& e) {
+                        result.error = "Error processing " + paths[file.index] + ": " + e.what();
+                    }
+                    double analyzeSeconds = seconds(analyzeStart, Clock::now());
+                    
+                    std::lock_guard<std::mutex> lock(mutex);
+                    ingestStats.analyzeSeconds += analyzeSeconds;
+                    ingestStats.bytes += file.data.empty() ? 0 : file.data.size() - 1;
+                    results.emplace(file.index, std::move(result));
+                    resultsReady.notify_one();
+                }
+            });
+        }
+        
+        auto shutdown = [&] {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            windowOpen.notify_all();
+            reader.join();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        };
+        
+        try {
+            size_t month = 0;
+            for (size_t next = 0; next < totalFiles; ++next) {
+                Result result;
+                auto waitStart = Clock::now();
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    resultsReady.wait(lock, [&] { return results.count(next) || readerError; });
+                    auto node = results.extract(next);
+                    if (node.empty()) {
+                        break;
+                    }
+                    result = std::move(node.mapped());
+                    committed = next + 1;
+                }
+                windowOpen.notify_one();
+                auto indexStart = Clock::now();
+                ingestStats.waitSeconds += seconds(waitStart, indexStart);
+                
+                while (month < months.size() && months[month].first == next) {
+                    std::cout << "\nProcessing " << months[month].second << ":\n";
+                    ++month;
+                }
+                
+                try {
+                    if (!result.error.empty()) {
+                        throw std::runtime_error(result.error);
+                    }
+                    uint32_t doc = indexArticle(result.article);
+                    if (manifest) {
+                        const ScannedFile& scannedFile = *pathFiles[next];
+                        manifest->set(scannedFile.relative, {scannedFile.size, scannedFile.modified, result.hash, doc});
+                    }
+                    processedFiles++;
+                    
+                    // Show progress every 100 files
+                    if (processedFiles % 100 == 0) {
+                        float progress = (float)processedFiles / totalFiles * 100;
+                        std::cout << "\rProgress: " << processedFiles << "/" << totalFiles 
+                                << " files (" << std::fixed << std::setprecision(1) 
+                                << progress << "%) - Errors: " << errorCount 
+                                << std::flush;
                     }
                 }
+                catch (const std::exception& e) {
+                    errorCount++;
+                    std::cerr << "\nError in file " << std::filesystem::path(paths[next]).filename() 
+                            << ": " << e.what() << std::endl;
+                }
+                ingestStats.indexSeconds += seconds(indexStart, Clock::now());
             }
         }
-
+        catch (...) {
+            shutdown();
+            throw;
+        }
+        shutdown();
+        
+        if (readerError) {
+            std::rethrow_exception(readerError);
+        }
+        
+        ingestStats.files = processedFiles;
+        
         std::cout << "\n\nIndexing complete:\n"
                   << "- Processed: " << processedFiles << "/" << totalFiles << " files\n"
                   << "- Successful: " << (processedFiles - errorCount) << " files\n"
                   << "- Errors: " << errorCount << " files\n";
-
-        if (processedFiles > 0) {
-            std::cout << "\nCalculating TF-IDF scores...\n";
-            calculateTFIDF();
-        }
     }
     catch (const std::exception& e) {
         throw std::runtime_error("Error processing directory: " + std::string(e.what()));
     }
 }
-
-void DocumentParser::calculateTFIDF() {
-    const size_t totalDocs = indexHandler.getTotalDocuments();
-    
-    // Example function to update TF-IDF scores
-    auto updateScores = [this, totalDocs](const std::string& term, 
-                                      std::unordered_map<std::string, double>& scores) {
-        size_t docFreq = indexHandler.getDocumentFrequency(term);
-        double idf = log10(static_cast<double>(totalDocs) / (1.0 + docFreq));
-        
-        for (auto& [docID, tf] : scores) {
-            // Update TF-IDF score
-            scores[docID] = tf * idf;
-        }
-    };
-    
-    // We would apply this to each term in the index
-    std::cout << "TF-IDF calculation complete.\n";
-}
\ No newline at end of file
@@ -0,0 +1,204 @@
+/**
+ * @file DocumentStore.cpp
+ * @author <YourName>
+ * @brief Implementation of the typed document metadata store
+ */
+
+#include "../include/DocumentStore.h"
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+
+namespace {
+
+// Parse exactly count digits at text[pos], advancing pos
+bool readDigits(std::string_view text, size_t& pos, size_t count, int& value) {
+    if (pos + count > text.size()) {
+        return false;
+    }
+    value = 0;
+    for (size_t i = 0; i < count; ++i) {
+        char c = text[pos + i];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+    }
+    pos += count;
+    return true;
+}
+
+bool expect(std::string_view text, size_t& pos, char c) {
+    if (pos < text.size() && text[pos] == c) {
+        ++pos;
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+int64_t DocumentStore::parseDate(std::string_view date) {
+    using namespace std::chrono;
+    
+    size_t pos = 0;
+    int y = 0, m = 0, d = 0;
+    if (!readDigits(date, pos, 4, y) || !expect(date, pos, '-') ||
+        !readDigits(date, pos, 2, m) || !expect(date, pos, '-') || !readDigits(date, pos, 2, d)) {
+        return kUnknownDate;
+    }
+    year_month_day calendarDate{year{y}, month{static_cast<unsigned>(m)}, day{static_cast<unsigned>(d)}};
+    if (!calendarDate.ok()) {
+        return kUnknownDate;
+    }
+    
+    int hours = 0, minutes = 0, seconds = 0, offset = 0;
+    if (expect(date, pos, 'T') || expect(date, pos, ' ')) {
+        if (!readDigits(date, pos, 2, hours) || !expect(date, pos, ':') || !readDigits(date, pos, 2, minutes)) {
+            return kUnknownDate;
+        }
+        if (expect(date, pos, ':') && !readDigits(date, pos, 2, seconds)) {
+            return kUnknownDate;
+        }
+        if (hours > 23 || minutes > 59 || seconds > 60) {
+            return kUnknownDate;
+        }
+        if (expect(date, pos, '.')) {
+            while (pos < date.size() && date[pos] >= '0' && date[pos] <= '9') {
+                ++pos;
+            }
+        }
+        
+        // A zone offset gives local time; subtract it to get UTC
+        if (pos < date.size() && (date[pos] == '+' || date[pos] == '-')) {
+            int sign = date[pos++] == '-' ? -1 : 1;
+            int offsetHours = 0, offsetMinutes = 0;
+            if (!readDigits(date, pos, 2, offsetHours)) {
+                return kUnknownDate;
+            }
+            expect(date, pos, ':');
+            if (!readDigits(date, pos, 2, offsetMinutes)) {
+                return kUnknownDate;
+            }
+            offset = sign * (offsetHours * 3600 + offsetMinutes * 60);
+        }
+        else {
+            expect(date, pos, 'Z');
+        }
+    }
+    
+    int64_t dayNumber = sys_days(calendarDate).time_since_epoch().count();
+    return dayNumber * 86400 + hours * 3600 + minutes * 60 + seconds - offset;
+}
+
+std::string DocumentStore::formatDate(int64_t published) {
+    using namespace std::chrono;
+    
+    if (published == kUnknownDate) {
+        return "Unknown Date";
+    }
+    
+    int64_t dayNumber = published >= 0 ? published / 86400 : (published - 86399) / 86400;
+    int64_t secondOfDay = published - dayNumber * 86400;
+    year_month_day calendarDate{sys_days{days{dayNumber}}};
+    
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02u-%02u %02d:%02d:%02d",
+                  static_cast<int>(calendarDate.year()), static_cast<unsigned>(calendarDate.month()),
+                  static_cast<unsigned>(calendarDate.day()), static_cast<int>(secondOfDay / 3600),
+                  static_cast<int>(secondOfDay / 60 % 60), static_cast<int>(secondOfDay % 60));
+    return buffer;
+}
+
+uint32_t DocumentStore::internSource(std::string_view source) {
+    auto it = sourceIDs.find(source);
+    if (it != sourceIDs.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(sources.size());
+    sources.emplace_back(source);
+    sourceIDs.emplace(sources.back(), id);
+    return id;
+}
+
+void DocumentStore::set(uint32_t doc, std::string_view title, int64_t published, std::string_view source) {
+    DocumentInfo& info = documents[doc];
+    info.titleOffset = titles.size();
+    info.titleLength = static_cast<uint32_t>(title.size());
+    titles.append(title);
+    info.source = internSource(source);
+    info.published = published;
+}
+
+DocumentView DocumentStore::get(uint32_t doc) const {
+    if (doc >= documents.size()) {
+        return {std::string_view(), std::string_view(), kUnknownDate};
+    }
+    const DocumentInfo& info = documents[doc];
+    return {std::string_view(titles).substr(info.titleOffset, info.titleLength), sources[info.source],
+            info.published};
+}
+
+void DocumentStore::clear() {
+    documents.clear();
+    titles.clear();
+    sources.assign(1, "");
+    sourceIDs.clear();
+    sourceIDs.emplace("", 0);
+}
+
+void DocumentStore::write(std::ofstream& out) const {
+    size_t count = documents.size();
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char*>(documents.data()), count * sizeof(DocumentInfo));
+    
+    size_t size = titles.size();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(titles.data(), size);
+    
+    count = sources.size();
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const auto& source : sources) {
+        size = source.size();
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.write(source.data(), size);
+    }
+}
+
+void DocumentStore::read(std::ifstream& in) {
+    clear();
+    
+    size_t count = 0;
+    in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    documents.resize(in ? count : 0);
+    in.read(reinterpret_cast<char*>(documents.data()), documents.size() * sizeof(DocumentInfo));
+    
+    size_t size = 0;
+    in.read(reinterpret_cast<char*>(&size), sizeof(size));
+    titles.assign(in ? size : 0, ' ');
+    in.read(&titles[0], titles.size());
+    
+    count = 0;
+    in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    sources.clear();
+    sourceIDs.clear();
+    for (size_t id = 0; id < count && in; ++id) {
+        in.read(reinterpret_cast<char*>(&size), sizeof(size));
+        std::string source(in ? size : 0, ' ');
+        in.read(&source[0], source.size());
+        sourceIDs.emplace(source, static_cast<uint32_t>(id));
+        sources.push_back(std::move(source));
+    }
+    
+    if (!in) {
+        throw std::runtime_error("Truncated document metadata");
+    }
+    if (sources.empty() || !sources[0].empty()) {
+        throw std::runtime_error("Corrupt document metadata");
+    }
+    for (const auto& info : documents) {
+        if (info.titleOffset + info.titleLength > titles.size() || info.source >= sources.size()) {
+            throw std::runtime_error("Corrupt document metadata");
+        }
+    }
+}
@@ -0,0 +1,144 @@
+/**
+ * @file EntityDictionary.cpp
+ * @author <YourName>
+ * @brief Implementation of entity name normalization and interning
+ */
+
+#include "../include/EntityDictionary.h"
+#include "../include/Tokenizer.h"
+
+namespace {
+
+void writeString(std::ofstream& out, const std::string& value) {
+    size_t size = value.size();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(value.data(), size);
+}
+
+std::string readString(std::ifstream& in) {
+    size_t size = 0;
+    in.read(reinterpret_cast<char*>(&size), sizeof(size));
+    std::string value(size, ' ');
+    in.read(&value[0], size);
+    return value;
+}
+
+} // namespace
+
+std::string EntityDictionary::normalize(std::string_view name) {
+    // Letters fold like tokens do, so "SOCIÉTÉ" and "société" are the same name
+    std::string folded = Tokenizer::foldCase(name);
+    std::string normalized;
+    normalized.reserve(folded.size());
+    
+    bool pendingSpace = false;
+    for (char c : folded) {
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v' || c == '_') {
+            pendingSpace = !normalized.empty();
+            continue;
+        }
+        if (pendingSpace) {
+            normalized.push_back(' ');
+            pendingSpace = false;
+        }
+        normalized.push_back(c);
+    }
+    return normalized;
+}
+
+void EntityDictionary::addAlias(std::string_view alias, std::string_view canonical) {
+    std::string from = normalize(alias);
+    std::string to = normalize(canonical);
+    if (from.empty() || to.empty() || from == to) {
+        return;
+    }
+    aliases.insert_or_assign(std::move(from), std::move(to));
+}
+
+bool EntityDictionary::loadAliases(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file) {
+        return false;
+    }
+    
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        size_t tab = line.find('\t');
+        if (tab != std::string::npos) {
+            addAlias(std::string_view(line).substr(0, tab), std::string_view(line).substr(tab + 1));
+        }
+    }
+    return true;
+}
+
+std::string_view EntityDictionary::resolve(std::string_view normalized) const {
+    // Follow chains (a -> b -> c), bounded so a cycle cannot loop forever
+    for (size_t hops = 0; hops < 8; ++hops) {
+        auto it = aliases.find(normalized);
+        if (it == aliases.end()) {
+            break;
+        }
+        normalized = it->second;
+    }
+    return normalized;
+}
+
+uint32_t EntityDictionary::intern(std::string_view name) {
+    std::string normalized = normalize(name);
+    std::string_view canonical = resolve(normalized);
+    
+    auto it = ids.find(canonical);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    
+    uint32_t id = static_cast<uint32_t>(names.size());
+    names.emplace_back(canonical);
+    ids.emplace(names.back(), id);
+    return id;
+}
+
+uint32_t EntityDictionary::lookup(std::string_view name) const {
+    std::string normalized = normalize(name);
+    auto it = ids.find(resolve(normalized));
+    return it != ids.end() ? it->second : kUnknown;
+}
+
+void EntityDictionary::write(std::ofstream& out) const {
+    size_t count = names.size();
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const auto& name : names) {
+        writeString(out, name);
+    }
+    
+    size_t aliasCount = aliases.size();
+    out.write(reinterpret_cast<const char*>(&aliasCount), sizeof(aliasCount));
+    for (const auto& [alias, canonical] : aliases) {
+        writeString(out, alias);
+        writeString(out, canonical);
+    }
+}
+
+void EntityDictionary::read(std::ifstream& in) {
+    names.clear();
+    ids.clear();
+    
+    size_t count = 0;
+    in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    names.reserve(count);
+    for (size_t id = 0; id < count; ++id) {
+        names.push_back(readString(in));
+        ids.emplace(names.back(), static_cast<uint32_t>(id));
+    }
+    
+    size_t aliasCount = 0;
+    in.read(reinterpret_cast<char*>(&aliasCount), sizeof(aliasCount));
+    for (size_t i = 0; i < aliasCount; ++i) {
+        std::string alias = readString(in);
+        std::string canonical = readString(in);
+        aliases.emplace(std::move(alias), std::move(canonical));
+    }
+}
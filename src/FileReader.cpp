@@ -0,0 +1,403 @@
+/**
+ * @file FileReader.cpp
+ * @author <YourName>
+ * @brief io_uring and pread implementations of FileReader
+ */
+
+#include "../include/FileReader.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define SUPERSEARCH_HAVE_IO_URING 1
+#endif
+
+namespace {
+
+/**
+ * @brief Blocking reader: open, fstat, pread until the whole file is in, close
+ */
+class PreadFileReader : public FileReader {
+public:
+    void readFiles(const std::vector<std::string>& paths, const Callback& onFile) override {
+        for (size_t i = 0; i < paths.size(); ++i) {
+            File file;
+            file.index = i;
+            file.error = readWhole(paths[i], file.data);
+            onFile(std::move(file));
+        }
+    }
+
+    const char* name() const override { return "pread"; }
+
+private:
+    static int readWhole(const std::string& path, std::vector<char>& data) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return errno;
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            int error = errno;
+            ::close(fd);
+            return error;
+        }
+
+        size_t size = static_cast<size_t>(info.st_size);
+        data.resize(size + 1);
+        size_t filled = 0;
+        while (filled < size) {
+            ssize_t got = ::pread(fd, data.data() + filled, size - filled, static_cast<off_t>(filled));
+            if (got < 0) {
+                if (errno == EINTR) continue;
+                int error = errno;
+                ::close(fd);
+                return error;
+            }
+            if (got == 0) break;
+            filled += static_cast<size_t>(got);
+        }
+        ::close(fd);
+
+        data.resize(filled + 1);
+        data[filled] = '\0';
+        return 0;
+    }
+};
+
+#ifdef SUPERSEARCH_HAVE_IO_URING
+
+/**
+ * @brief Minimal io_uring wrapper over the raw system calls (no liburing dependency)
+ */
+class Ring {
+public:
+    explicit Ring(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+
+        fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) {
+            throw std::runtime_error(std::string("io_uring_setup failed: ") + std::strerror(errno));
+        }
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMap) {
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        }
+
+        try {
+            sqRing = map(sqRingSize, IORING_OFF_SQ_RING);
+            cqRing = singleMap ? sqRing : map(cqRingSize, IORING_OFF_CQ_RING);
+            sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            sqes = static_cast<io_uring_sqe*>(map(sqesSize, IORING_OFF_SQES));
+        }
+        catch (...) {
+            release();
+            throw;
+        }
+
+        char* sq = static_cast<char*>(sqRing);
+        sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sqEntries = params.sq_entries;
+        localTail = *sqTail;
+
+        char* cq = static_cast<char*>(cqRing);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    ~Ring() {
+        release();
+    }
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    /**
+     * @brief Check that the kernel implements every listed opcode
+     */
+    bool supports(std::initializer_list<int> opcodes) const {
+        constexpr unsigned kProbeOps = 256;
+        std::vector<char> buffer(sizeof(io_uring_probe) + kProbeOps * sizeof(io_uring_probe_op));
+        auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+        if (::syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, kProbeOps) < 0) {
+            return false;
+        }
+        for (int op : opcodes) {
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Next free submission entry, zeroed; nullptr if the queue is full
+     */
+    io_uring_sqe* nextSqe() {
+        if (localTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries) {
+            return nullptr;
+        }
+        unsigned index = localTail & sqMask;
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqArray[index] = index;
+        ++localTail;
+        ++pending;
+        return sqe;
+    }
+
+    /**
+     * @brief Submit queued entries and optionally wait for completions
+     * @param waitFor Minimum number of completions to wait for
+     */
+    void submit(unsigned waitFor) {
+        __atomic_store_n(sqTail, localTail, __ATOMIC_RELEASE);
+        while (pending > 0 || waitFor > 0) {
+            int done = static_cast<int>(::syscall(__NR_io_uring_enter, fd, pending, waitFor,
+                                                  waitFor ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+            if (done < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(std::string("io_uring_enter failed: ") + std::strerror(errno));
+            }
+            pending -= static_cast<unsigned>(done);
+            waitFor = 0;
+        }
+    }
+
+    /**
+     * @brief Hand every available completion to handler
+     */
+    template<typename Handler>
+    void drain(Handler&& handler) {
+        unsigned head = *cqHead;
+        unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            io_uring_cqe cqe = cqes[head & cqMask];
+            ++head;
+            __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+            handler(cqe);
+            tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        }
+    }
+
+private:
+    void release() {
+        if (sqes) ::munmap(sqes, sqesSize);
+        if (cqRing && cqRing != sqRing) ::munmap(cqRing, cqRingSize);
+        if (sqRing) ::munmap(sqRing, sqRingSize);
+        if (fd >= 0) ::close(fd);
+    }
+
+    void* map(size_t size, off_t offset) {
+        void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+        if (ptr == MAP_FAILED) {
+            throw std::runtime_error(std::string("io_uring mmap failed: ") + std::strerror(errno));
+        }
+        return ptr;
+    }
+
+    int fd = -1;
+    void* sqRing = nullptr;
+    void* cqRing = nullptr;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    size_t sqesSize = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    unsigned localTail = 0;
+    unsigned pending = 0;
+
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+};
+
+/**
+ * @brief Asynchronous reader: each file is an OPENAT, one or more READs and a CLOSE
+ *
+ * Up to kSlots files are in flight. A file's read is issued into a buffer of
+ * kInitialCapacity bytes; a short read marks end of file (regular files only
+ * return short at EOF), and a full buffer is doubled and read again.
+ */
+class UringFileReader : public FileReader {
+public:
+    UringFileReader() : ring(kSlots * 2) {
+        if (!ring.supports({IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_CLOSE})) {
+            throw std::runtime_error("io_uring lacks OPENAT/READ/CLOSE support (kernel 5.6+ required)");
+        }
+    }
+
+    void readFiles(const std::vector<std::string>& paths, const Callback& onFile) override {
+        std::vector<Slot> slots(kSlots);
+        std::vector<uint32_t> freeSlots;
+        for (uint32_t i = kSlots; i > 0; --i) {
+            freeSlots.push_back(i - 1);
+        }
+
+        size_t next = 0;
+        size_t active = 0;
+        std::vector<bool> completed(paths.size());
+        size_t lowestIncomplete = 0;
+
+        auto finish = [&](uint32_t id, int error) {
+            Slot& slot = slots[id];
+            File file;
+            file.index = slot.index;
+            file.error = error;
+            if (error == 0) {
+                slot.data.resize(slot.filled + 1);
+                slot.data[slot.filled] = '\0';
+                file.data = std::move(slot.data);
+            }
+            if (slot.fd >= 0) {
+                io_uring_sqe* sqe = ring.nextSqe();
+                sqe->opcode = IORING_OP_CLOSE;
+                sqe->fd = slot.fd;
+                sqe->user_data = encode(id, Op::Close);
+            }
+            completed[slot.index] = true;
+            while (lowestIncomplete < paths.size() && completed[lowestIncomplete]) {
+                ++lowestIncomplete;
+            }
+            slot = Slot();
+            freeSlots.push_back(id);
+            --active;
+            onFile(std::move(file));
+        };
+
+        while (next < paths.size() || active > 0) {
+            // Keep every free slot busy with the next file
+            while (next < paths.size() && !freeSlots.empty() && 
+                   next < lowestIncomplete + kMaxReadAhead) {
+                uint32_t id = freeSlots.back();
+                freeSlots.pop_back();
+                slots[id].index = next;
+
+                io_uring_sqe* sqe = ring.nextSqe();
+                sqe->opcode = IORING_OP_OPENAT;
+                sqe->fd = AT_FDCWD;
+                sqe->addr = reinterpret_cast<uint64_t>(paths[next].c_str());
+                sqe->open_flags = O_RDONLY | O_CLOEXEC;
+                sqe->user_data = encode(id, Op::Open);
+                ++next;
+                ++active;
+            }
+
+            ring.submit(1);
+            ring.drain([&](const io_uring_cqe& cqe) {
+                uint32_t id = static_cast<uint32_t>(cqe.user_data >> 2);
+                Op op = static_cast<Op>(cqe.user_data & 3);
+                if (op == Op::Close) {
+                    return;
+                }
+
+                Slot& slot = slots[id];
+                if (cqe.res < 0) {
+                    finish(id, -cqe.res);
+                    return;
+                }
+
+                if (op == Op::Open) {
+                    slot.fd = cqe.res;
+                    slot.data.resize(kInitialCapacity);
+                }
+                else {
+                    size_t requested = slot.data.size() - slot.filled;
+                    slot.filled += static_cast<size_t>(cqe.res);
+                    if (static_cast<size_t>(cqe.res) < requested) {
+                        finish(id, 0);
+                        return;
+                    }
+                    slot.data.resize(slot.data.size() * 2);
+                }
+
+                io_uring_sqe* sqe = ring.nextSqe();
+                sqe->opcode = IORING_OP_READ;
+                sqe->fd = slot.fd;
+                sqe->addr = reinterpret_cast<uint64_t>(slot.data.data() + slot.filled);
+                sqe->len = static_cast<uint32_t>(slot.data.size() - slot.filled);
+                sqe->off = slot.filled;
+                sqe->user_data = encode(id, Op::Read);
+            });
+        }
+
+        // Flush the final closes
+        ring.submit(0);
+    }
+
+    const char* name() const override { return "io_uring"; }
+
+private:
+    enum class Op : uint64_t { Open = 0, Read = 1, Close = 2 };
+
+    struct Slot {
+        size_t index = 0;
+        int fd = -1;
+        std::vector<char> data;
+        size_t filled = 0;
+    };
+
+    static uint64_t encode(uint32_t slot, Op op) {
+        return (static_cast<uint64_t>(slot) << 2) | static_cast<uint64_t>(op);
+    }
+
+    // A slot has at most two operations outstanding (its close and the next
+    // file's open), so a ring of 2 * kSlots entries never overflows
+    static constexpr uint32_t kSlots = 256;
+    static constexpr size_t kInitialCapacity = 64 * 1024;
+
+    Ring ring;
+};
+
+#endif
+
+} // namespace
+
+std::unique_ptr<FileReader> FileReader::create(Kind kind) {
+    if (kind == Kind::Pread) {
+        return std::make_unique<PreadFileReader>();
+    }
+
+#ifdef SUPERSEARCH_HAVE_IO_URING
+    try {
+        return std::make_unique<UringFileReader>();
+    }
+    catch (const std::exception&) {
+        if (kind == Kind::Uring) {
+            throw;
+        }
+    }
+#else
+    if (kind == Kind::Uring) {
+        throw std::runtime_error("io_uring is not available on this platform");
+    }
+#endif
+
+    return std::make_unique<PreadFileReader>();
+}
@@ -5,64 +5,616 @@
  */
 
 #include "../include/IndexHandler.h"
+#include "../include/LevenshteinAutomaton.h"
 #include <fstream>
 #include <iostream>
 #include <filesystem>
-#include "../thirdparty/rapidjson/include/rapidjson/writer.h"
-#include "../thirdparty/rapidjson/include/rapidjson/stringbuffer.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <queue>
+#include <random>
+
+namespace {
+
+// Heap-allocated AVL node, key and control block of a term that is new in memory
+constexpr size_t kTermOverhead = 256;
+
+// Leads the metadata file; the version changes whenever the index files change layout
+constexpr uint32_t kMetaMagic = 0x444d5353;   // "SSMD"
+constexpr uint32_t kMetaVersion = 3;
+
+/**
+ * @brief Create a new, uniquely named directory for index runs under the temp directory
+ *
+ * create_directory returns false when the name is taken, so a name shared with
+ * another process or index is retried with the next one.
+ */
+std::filesystem::path createRunDirectory() {
+    static std::atomic<uint64_t> counter{0};
+    std::random_device random;
+    std::filesystem::path base = std::filesystem::temp_directory_path();
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        std::filesystem::path directory = base / ("supersearch-runs-" + std::to_string(random()) + "-" +
+                                                  std::to_string(counter++));
+        std::error_code error;
+        if (std::filesystem::create_directory(directory, error)) {
+            return directory;
+        }
+        if (error) {
+            throw std::runtime_error("Failed to create directory for index runs: " + directory.string() +
+                                     ": " + error.message());
+        }
+    }
+    throw std::runtime_error("Failed to create directory for index runs under " + base.string());
+}
+
+/**
+ * @brief Sequential reader of a run file: (key size, key, postings) entries in key order
+ */
+struct RunReader {
+    std::ifstream in;
+    std::string key;
+    PostingList postings;
+    
+    explicit RunReader(const std::string& filename) : in(filename, std::ios::binary) {
+        if (!in) {
+            throw std::runtime_error("Failed to open index run for reading: " + filename);
+        }
+    }
+    
+    /**
+     * @brief Read the next entry
+     * @return false at the end of the run
+     */
+    bool next() {
+        size_t keySize = 0;
+        if (!in.read(reinterpret_cast<char*>(&keySize), sizeof(keySize))) {
+            return false;
+        }
+        key.resize(keySize);
+        in.read(key.data(), keySize);
+        postings.read(in);
+        if (!in) {
+            throw std::runtime_error("Truncated index run");
+        }
+        return true;
+    }
+};
+
+void writeEntry(std::ofstream& out, const std::string& key, const PostingList& postings) {
+    size_t keySize = key.size();
+    out.write(reinterpret_cast<const char*>(&keySize), sizeof(keySize));
+    out.write(key.data(), keySize);
+    postings.write(out);
+}
+
+void copyBytes(std::ifstream& in, std::ofstream& out, uint64_t offset, uint64_t size) {
+    static thread_local std::vector<char> buffer(1 << 20);
+    in.seekg(static_cast<std::streamoff>(offset));
+    while (size > 0) {
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(size, buffer.size()));
+        if (!in.read(buffer.data(), chunk)) {
+            throw std::runtime_error("Truncated merged word index");
+        }
+        out.write(buffer.data(), chunk);
+        size -= chunk;
+    }
+}
+
+} // namespace
+
+IndexHandler::~IndexHandler() {
+    removeRuns();
+}
 
 size_t IndexHandler::getTotalDocuments() const {
-    return documentIDs.size();
+    return documentIDs.size() - deletedCount;
 }
 
 size_t IndexHandler::getDocumentFrequency(const std::string& term) const {
-    auto results = wordIndex.search(term);
-    return results.size();
+    const PostingList* postings = wordIndex.find(term);
+    return postings ? postings->documentFrequency() : 0;
+}
+
+double IndexHandler::getAverageDocumentLength() const {
+    if (getTotalDocuments() == 0) {
+        return 1.0;
+    }
+    return std::max(1.0, static_cast<double>(totalDocumentLength) / getTotalDocuments());
+}
+
+void IndexHandler::addTerm(const std::string& term, uint32_t doc, uint32_t tf) {
+    ++generation;
+    PostingList& postings = wordIndex.getOrInsert(term);
+    size_t before = postings.memoryUsage();
+    postings.add(doc, tf);
+    trackWordMemory(term, before, postings.memoryUsage());
+}
+
+void IndexHandler::addTermPositions(const std::string& term, uint32_t doc, 
+                                    const uint32_t* positions, uint32_t count) {
+    ++generation;
+    PostingList& postings = wordIndex.getOrInsert(term);
+    size_t before = postings.memoryUsage();
+    postings.addWithPositions(doc, positions, count);
+    trackWordMemory(term, before, postings.memoryUsage());
+}
+
+void IndexHandler::trackWordMemory(const std::string& term, size_t before, size_t after) {
+    // A list with nothing allocated yet was just inserted into the tree
+    wordIndexBytes += after - before + (before == 0 ? kTermOverhead + term.capacity() : 0);
+}
+
+void IndexHandler::addEntity(std::vector<PostingList>& postings, uint32_t id, uint32_t doc) {
+    if (id >= postings.size()) {
+        postings.resize(id + 1);
+    }
+    postings[id].add(doc, 1);
+}
+
+void IndexHandler::addOrganization(std::string_view org, uint32_t doc) {
+    ++generation;
+    addEntity(organizationPostings, organizationNames.intern(org), doc);
+}
+
+void IndexHandler::addPerson(std::string_view person, uint32_t doc) {
+    ++generation;
+    addEntity(personPostings, personNames.intern(person), doc);
+}
+
+bool IndexHandler::loadAliases(const std::string& filename) {
+    ++generation;
+    return organizationNames.loadAliases(filename) && personNames.loadAliases(filename);
+}
+
+void IndexHandler::countBigram(const std::string& first, const std::string& second, uint32_t count) {
+    std::string key;
+    key.reserve(first.size() + second.size() + 1);
+    key.append(first).append(1, ' ').append(second);
+    
+    auto it = bigramCounts.find(key);
+    if (it != bigramCounts.end()) {
+        it->second += count;
+        return;
+    }
+    
+    // New pairs may have been pruned before, so they start at the pruning floor
+    bigramCounts.emplace(std::move(key), bigramCountFloor + count);
+    if (bigramCounts.size() > 2 * std::max<size_t>(bigramLimit * 8, 1024)) {
+        pruneBigramCounts();
+    }
+}
+
+void IndexHandler::pruneBigramCounts() {
+    size_t keep = std::max<size_t>(bigramLimit * 8, 1024);
+    if (bigramCounts.size() <= keep) {
+        return;
+    }
+    
+    std::vector<uint64_t> counts;
+    counts.reserve(bigramCounts.size());
+    for (const auto& [key, count] : bigramCounts) {
+        counts.push_back(count);
+    }
+    std::nth_element(counts.begin(), counts.begin() + keep, counts.end(), std::greater<uint64_t>());
+    uint64_t threshold = counts[keep];
+    
+    for (auto it = bigramCounts.begin(); it != bigramCounts.end(); ) {
+        if (it->second <= threshold) {
+            it = bigramCounts.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    bigramCountFloor = std::max(bigramCountFloor, threshold);
+}
+
+void IndexHandler::buildBigramIndex() {
+    if (bigramsCurrent || !runFiles.empty()) {
+        return;
+    }
+    
+    buildBigramIndex(bigramCandidates(), [this](const std::string& term, PostingList&) {
+        return wordIndex.find(term);
+    });
+}
+
+void IndexHandler::buildScoreBounds() {
+    if (!runFiles.empty()) {
+        return;
+    }
+    wordIndex.traverseValues([this](const std::string&, PostingList& list) {
+        if (!list.hasBlocks()) {
+            list.buildBlocks(documentLengths);
+        }
+    });
+}
+
+void IndexHandler::buildWordTrie() {
+    if (!runFiles.empty()) {
+        return;
+    }
+    // Keys are stable while the tree is unchanged, so views avoid copying them
+    std::vector<std::string_view> words;
+    wordIndex.traverseValues([&](const std::string& key, const PostingList&) {
+        words.push_back(key);
+    });
+    wordTrie.build(words);
+    wordTrieGeneration = generation;
+}
+
+std::vector<std::pair<uint64_t, std::string>> IndexHandler::bigramCandidates() const {
+    // Candidates: pairs indexed before (counts from earlier sessions are not
+    // kept) plus the most frequent pairs counted since
+    std::vector<std::pair<uint64_t, std::string>> candidates;
+    for (const auto& [key, count] : bigramCounts) {
+        candidates.emplace_back(count, key);
+    }
+    bigramIndex.traverseValues([&](const std::string& key, const PostingList& list) {
+        if (!bigramCounts.count(key)) {
+            uint64_t frequency = 0;
+            for (const auto& posting : list.postings) {
+                frequency += posting.tf;
+            }
+            candidates.emplace_back(frequency, key);
+        }
+    });
+    
+    size_t considered = std::min(candidates.size(), bigramLimit * 2);
+    std::partial_sort(candidates.begin(), candidates.begin() + considered, candidates.end(),
+                      std::greater<std::pair<uint64_t, std::string>>());
+    candidates.resize(considered);
+    return candidates;
+}
+
+void IndexHandler::buildBigramIndex(const std::vector<std::pair<uint64_t, std::string>>& candidates,
+                                    const WordSource& words) {
+    ++generation;
+    bigramsCurrent = true;
+    
+    // Exact postings from the words' positions: the second word directly follows the first
+    struct Built {
+        uint64_t frequency = 0;
+        std::string key;
+        PostingList postings;
+    };
+    std::vector<Built> built;
+    PostingList firstStorage, secondStorage;
+    std::vector<uint32_t> firstPositions, secondPositions, matches;
+    
+    for (const auto& [count, key] : candidates) {
+        size_t space = key.find(' ');
+        const PostingList* first = words(key.substr(0, space), firstStorage);
+        const PostingList* second = first ? words(key.substr(space + 1), secondStorage) : nullptr;
+        if (!first || !second || !first->hasPositions() || !second->hasPositions()) {
+            continue;
+        }
+        
+        Built bigram;
+        bigram.key = key;
+        size_t i = 0, j = 0;
+        while (i < first->postings.size() && j < second->postings.size()) {
+            uint32_t a = first->postings[i].doc;
+            uint32_t b = second->postings[j].doc;
+            if (a < b) { ++i; continue; }
+            if (b < a) { ++j; continue; }
+            
+            first->decodePositions(i, firstPositions);
+            second->decodePositions(j, secondPositions);
+            matches.clear();
+            size_t k = 0;
+            for (uint32_t position : firstPositions) {
+                while (k < secondPositions.size() && secondPositions[k] <= position) {
+                    ++k;
+                }
+                if (k < secondPositions.size() && secondPositions[k] == position + 1) {
+                    matches.push_back(position);
+                }
+            }
+            if (!matches.empty()) {
+                bigram.postings.addWithPositions(a, matches.data(), static_cast<uint32_t>(matches.size()));
+                bigram.frequency += matches.size();
+            }
+            ++i;
+            ++j;
+        }
+        
+        if (bigram.frequency > 0) {
+            built.push_back(std::move(bigram));
+        }
+    }
+    
+    // Keep the top bigramLimit by exact collection frequency
+    size_t kept = std::min(built.size(), bigramLimit);
+    std::partial_sort(built.begin(), built.begin() + kept, built.end(),
+                      [](const Built& x, const Built& y) {
+                          return x.frequency != y.frequency ? x.frequency > y.frequency : x.key < y.key;
+                      });
+    
+    // Pairs are found in deleted documents too, which must not count toward df
+    std::vector<uint32_t> deleted;
+    for (uint32_t doc = 0; doc < deletedDocuments.size(); ++doc) {
+        if (deletedDocuments[doc]) {
+            deleted.push_back(doc);
+        }
+    }
+    
+    bigramIndex.clear();
+    for (size_t n = 0; n < kept; ++n) {
+        PostingList& list = bigramIndex.getOrInsert(built[n].key);
+        list = std::move(built[n].postings);
+        list.markDeleted(deleted);
+    }
+}
+
+const PostingList* IndexHandler::getBigramPostings(const std::string& first, const std::string& second) const {
+    if (!bigramsCurrent) {
+        return nullptr;
+    }
+    return bigramIndex.find(first + " " + second);
+}
+
+bool IndexHandler::hasDocument(const std::string& docID) const {
+    return documentOrdinals.count(docID) > 0;
+}
+
+uint32_t IndexHandler::findDocument(const std::string& docID) const {
+    auto it = documentOrdinals.find(docID);
+    return it != documentOrdinals.end() ? it->second : kNoDocument;
+}
+
+uint32_t IndexHandler::registerDocument(const std::string& docID) {
+    ++generation;
+    auto [it, inserted] = documentOrdinals.emplace(docID, static_cast<uint32_t>(documentIDs.size()));
+    if (inserted) {
+        // Spill between documents, so no document is split across runs
+        if (memoryBudget > 0 && wordIndexBytes > memoryBudget) {
+            spillRun();
+        }
+        bigramsCurrent = false;
+        documentIDs.push_back(docID);
+        documentInfo.add();
+        documentLengths.push_back(0);
+    }
+    return it->second;
 }
 
-void IndexHandler::addTerm(const std::string& term, const std::string& docID, double score) {
-    wordIndex.insert(term, docID, score);
+void IndexHandler::addDuplicate(const std::string& docID, uint32_t canonical) {
+    ++generation;
+    if (documentOrdinals.emplace(docID, canonical).second) {
+        duplicateCount++;
+    }
 }
 
-void IndexHandler::addOrganization(const std::string& org, const std::string& docID) {
-    organizationIndex.insert(org, docID, 1.0);
+void IndexHandler::deleteDocuments(const std::vector<uint32_t>& docs) {
+    ++generation;
+    deletedDocuments.resize(documentIDs.size(), false);
+    std::vector<uint32_t> removed;
+    for (uint32_t doc : docs) {
+        if (doc < documentIDs.size() && !deletedDocuments[doc]) {
+            removed.push_back(doc);
+            deletedDocuments[doc] = true;
+            deletedCount++;
+            totalDocumentLength -= documentLengths[doc];
+            documentInfo.erase(doc);
+            nearDuplicates.erase(doc);
+        }
+    }
+    if (removed.empty()) {
+        return;
+    }
+    
+    // Document frequencies count only live documents, so IDF stays positive
+    // and the planner orders every kind of term by its live df
+    std::sort(removed.begin(), removed.end());
+    auto markDeleted = [&removed](const std::string&, PostingList& list) {
+        list.markDeleted(removed);
+    };
+    wordIndex.traverseValues(markDeleted);
+    bigramIndex.traverseValues(markDeleted);
+    for (auto* entityPostings : {&organizationPostings, &personPostings}) {
+        for (PostingList& list : *entityPostings) {
+            list.markDeleted(removed);
+        }
+    }
+    
+    // One pass over the IDs drops the deleted documents and their collapsed duplicates
+    for (auto it = documentOrdinals.begin(); it != documentOrdinals.end(); ) {
+        if (deletedDocuments[it->second]) {
+            if (documentIDs[it->second] != it->first) {
+                duplicateCount--;
+            }
+            it = documentOrdinals.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
 }
 
-void IndexHandler::addPerson(const std::string& person, const std::string& docID) {
-    personIndex.insert(person, docID, 1.0);
+void IndexHandler::setDocumentLength(uint32_t doc, uint32_t length) {
+    ++generation;
+    if (isDeleted(doc)) {
+        return;
+    }
+    totalDocumentLength -= documentLengths[doc];
+    documentLengths[doc] = length;
+    totalDocumentLength += length;
 }
 
-void IndexHandler::registerDocument(const std::string& docID) {
-    documentIDs.insert(docID);
+void IndexHandler::addDocumentMetadata(uint32_t doc, std::string_view title, 
+                                     int64_t published, std::string_view source) {
+    ++generation;
+    documentInfo.set(doc, title, published, source);
 }
 
-void IndexHandler::addDocumentMetadata(const std::string& docID, const std::string& title, 
-                                     const std::string& date, const std::string& source) {
-    rapidjson::StringBuffer buffer;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+void IndexHandler::spillRun() {
+    ++generation;
+    if (runDirectory.empty()) {
+        runDirectory = createRunDirectory();
+    }
     
-    writer.StartObject();
-    writer.Key("title");
-    writer.String(title.c_str());
-    writer.Key("date");
-    writer.String(date.c_str());
-    writer.Key("source");
-    writer.String(source.c_str());
-    writer.EndObject();
+    std::string filename = (runDirectory / ("run-" + std::to_string(runFiles.size()))).string();
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Failed to open index run for writing: " + filename);
+    }
+    
+    // In-order traversal writes the run sorted by term
+    wordIndex.traverseValues([&](const std::string& key, const PostingList& postings) {
+        writeEntry(out, key, postings);
+    });
+    if (!out.flush()) {
+        throw std::runtime_error("Failed to write index run: " + filename);
+    }
     
-    documentMetadata[docID] = buffer.GetString();
+    runFiles.push_back(filename);
+    wordIndex.clear();
+    wordIndexBytes = 0;
 }
 
-std::string IndexHandler::getDocumentMetadata(const std::string& docID) const {
-    auto it = documentMetadata.find(docID);
-    if (it != documentMetadata.end()) {
-        return it->second;
+void IndexHandler::mergeRuns(const std::string& filename) {
+    if (!wordIndex.isEmpty()) {
+        spillRun();
     }
-    return "{}";
+    
+    // Words of the bigram candidates; their merged lists are read back for the bigram build
+    std::vector<std::pair<uint64_t, std::string>> candidates;
+    std::unordered_map<std::string, uint64_t> candidateWords;  // word -> offset of its merged entry
+    if (!bigramsCurrent && bigramLimit > 0) {
+        candidates = bigramCandidates();
+        for (const auto& [count, key] : candidates) {
+            size_t space = key.find(' ');
+            candidateWords.emplace(key.substr(0, space), UINT64_MAX);
+            candidateWords.emplace(key.substr(space + 1), UINT64_MAX);
+        }
+    }
+    
+    std::vector<std::unique_ptr<RunReader>> readers;
+    for (const auto& run : runFiles) {
+        readers.push_back(std::make_unique<RunReader>(run));
+    }
+    
+    // Min-heap of runs by current term; equal terms come out oldest run first,
+    // which keeps every merged list in document order
+    auto later = [&](size_t a, size_t b) {
+        int order = readers[a]->key.compare(readers[b]->key);
+        return order != 0 ? order > 0 : a > b;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(later);
+    for (size_t run = 0; run < readers.size(); ++run) {
+        if (readers[run]->next()) {
+            heap.push(run);
+        }
+    }
+    
+    // Pass 1: merged entries in term order, remembering where each one starts
+    std::string mergedFile = filename + ".merging";
+    std::vector<uint64_t> offsets;
+    {
+        std::ofstream merged(mergedFile, std::ios::binary);
+        if (!merged) {
+            throw std::runtime_error("Failed to open file for writing: " + mergedFile);
+        }
+        
+        std::string key;
+        PostingList postings;
+        while (!heap.empty()) {
+            size_t run = heap.top();
+            heap.pop();
+            key = readers[run]->key;
+            postings = std::move(readers[run]->postings);
+            if (readers[run]->next()) {
+                heap.push(run);
+            }
+            
+            while (!heap.empty() && readers[heap.top()]->key == key) {
+                size_t other = heap.top();
+                heap.pop();
+                postings.append(readers[other]->postings);
+                if (readers[other]->next()) {
+                    heap.push(other);
+                }
+            }
+            
+            uint64_t offset = static_cast<uint64_t>(merged.tellp());
+            offsets.push_back(offset);
+            auto word = candidateWords.find(key);
+            if (word != candidateWords.end()) {
+                word->second = offset;
+            }
+            writeEntry(merged, key, postings);
+        }
+        offsets.push_back(static_cast<uint64_t>(merged.tellp()));
+        
+        if (!merged.flush()) {
+            throw std::runtime_error("Failed to write merged word index: " + mergedFile);
+        }
+    }
+    readers.clear();
+    
+    // Pass 2: copy the entries into the tree layout, each subtree rooted at its
+    // middle term so the loaded tree is balanced
+    std::ifstream in(mergedFile, std::ios::binary);
+    std::ofstream out(filename, std::ios::binary);
+    if (!in || !out) {
+        throw std::runtime_error("Failed to open file for writing: " + filename);
+    }
+    
+    std::function<void(size_t, size_t)> writeSubtree = [&](size_t begin, size_t end) {
+        size_t middle = begin + (end - begin) / 2;
+        copyBytes(in, out, offsets[middle], offsets[middle + 1] - offsets[middle]);
+        
+        bool hasLeft = begin < middle;
+        out.write(reinterpret_cast<const char*>(&hasLeft), sizeof(hasLeft));
+        if (hasLeft) writeSubtree(begin, middle);
+        
+        bool hasRight = middle + 1 < end;
+        out.write(reinterpret_cast<const char*>(&hasRight), sizeof(hasRight));
+        if (hasRight) writeSubtree(middle + 1, end);
+    };
+    
+    size_t termCount = offsets.size() - 1;
+    bool hasRoot = termCount > 0;
+    out.write(reinterpret_cast<const char*>(&hasRoot), sizeof(hasRoot));
+    if (hasRoot) writeSubtree(0, termCount);
+    if (!out.flush()) {
+        throw std::runtime_error("Failed to write word index: " + filename);
+    }
+    
+    // Bigrams from the merged lists, two word lists in memory at a time
+    if (!bigramsCurrent) {
+        buildBigramIndex(candidates, [&](const std::string& term, PostingList& storage) -> const PostingList* {
+            auto word = candidateWords.find(term);
+            if (word == candidateWords.end() || word->second == UINT64_MAX) {
+                return nullptr;
+            }
+            in.clear();
+            in.seekg(static_cast<std::streamoff>(word->second + sizeof(size_t) + term.size()));
+            storage.read(in);
+            return &storage;
+        });
+    }
+    
+    in.close();
+    std::filesystem::remove(mergedFile);
+    removeRuns();
+}
+
+void IndexHandler::removeRuns() {
+    if (!runDirectory.empty()) {
+        std::error_code error;
+        std::filesystem::remove_all(runDirectory, error);
+    }
+    runDirectory.clear();
+    runFiles.clear();
 }
 
-void IndexHandler::saveIndices(const std::string& basePath) const {
+void IndexHandler::saveIndices(const std::string& basePath) {
     std::cout << "Saving indices to " << basePath << "..." << std::endl;
+    ++generation;  // merging runs empties the in-memory word index
     
     try {
         // Create directory if it doesn't exist
@@ -71,38 +623,83 @@ void IndexHandler::saveIndices(const std::string& basePath) const {
             std::filesystem::create_directories(dirPath);
         }
         
-        // Save word index
-        wordIndex.serialize(basePath + ".words");
+        auto writePostings = [](std::ofstream& out, const PostingList& postings) {
+            postings.write(out);
+        };
         
-        // Save organization index
-        organizationIndex.serialize(basePath + ".orgs");
+        // Save word index, merging any spilled runs into it
+        if (runFiles.empty()) {
+            wordIndex.serialize(basePath + ".words", writePostings);
+        }
+        else {
+            std::cout << "Merging " << runFiles.size() << " index runs..." << std::endl;
+            mergeRuns(basePath + ".words");
+        }
+        
+        // Save bigram pseudo-terms (an out-of-date bigram index is saved empty)
+        if (bigramsCurrent) {
+            bigramIndex.serialize(basePath + ".bigrams", writePostings);
+        }
+        else {
+            AVLTree<std::string, PostingList>().serialize(basePath + ".bigrams", writePostings);
+        }
         
-        // Save person index
-        personIndex.serialize(basePath + ".persons");
+        // Save entity dictionaries with their ID-indexed postings
+        saveEntities(basePath + ".orgs", organizationNames, organizationPostings);
+        saveEntities(basePath + ".persons", personNames, personPostings);
         
-        // Save document metadata
+        // Save document metadata, in ordinal order
         std::ofstream metaFile(basePath + ".meta", std::ios::binary);
         if (!metaFile) {
             throw std::runtime_error("Failed to open metadata file for writing");
         }
         
+        metaFile.write(reinterpret_cast<const char*>(&kMetaMagic), sizeof(kMetaMagic));
+        metaFile.write(reinterpret_cast<const char*>(&kMetaVersion), sizeof(kMetaVersion));
+        
         size_t docCount = documentIDs.size();
         metaFile.write(reinterpret_cast<const char*>(&docCount), sizeof(docCount));
         
-        for (const auto& docID : documentIDs) {
+        for (size_t doc = 0; doc < docCount; ++doc) {
+            const std::string& docID = documentIDs[doc];
             size_t idSize = docID.size();
             metaFile.write(reinterpret_cast<const char*>(&idSize), sizeof(idSize));
             metaFile.write(docID.c_str(), idSize);
             
-            auto metadata = documentMetadata.find(docID);
-            std::string metaStr = (metadata != documentMetadata.end()) ? 
-                                metadata->second : "{}";
-            
-            size_t metaSize = metaStr.size();
-            metaFile.write(reinterpret_cast<const char*>(&metaSize), sizeof(metaSize));
-            metaFile.write(metaStr.c_str(), metaSize);
+            uint32_t docLength = documentLengths[doc];
+            metaFile.write(reinterpret_cast<const char*>(&docLength), sizeof(docLength));
+        }
+        
+        metaFile.write(reinterpret_cast<const char*>(&storePositions), sizeof(storePositions));
+        
+        // Near-duplicate state: fingerprints by ordinal, then IDs collapsed into other documents
+        metaFile.write(reinterpret_cast<const char*>(&detectDuplicates), sizeof(detectDuplicates));
+        const std::vector<uint64_t>& fingerprints = nearDuplicates.fingerprints();
+        size_t fingerprintCount = fingerprints.size();
+        metaFile.write(reinterpret_cast<const char*>(&fingerprintCount), sizeof(fingerprintCount));
+        metaFile.write(reinterpret_cast<const char*>(fingerprints.data()), fingerprintCount * sizeof(uint64_t));
+        
+        metaFile.write(reinterpret_cast<const char*>(&duplicateCount), sizeof(duplicateCount));
+        for (const auto& [docID, doc] : documentOrdinals) {
+            if (documentIDs[doc] != docID) {
+                size_t idSize = docID.size();
+                metaFile.write(reinterpret_cast<const char*>(&idSize), sizeof(idSize));
+                metaFile.write(docID.c_str(), idSize);
+                metaFile.write(reinterpret_cast<const char*>(&doc), sizeof(doc));
+            }
+        }
+        
+        // Tombstoned ordinals
+        metaFile.write(reinterpret_cast<const char*>(&deletedCount), sizeof(deletedCount));
+        for (uint32_t doc = 0; doc < deletedDocuments.size(); ++doc) {
+            if (deletedDocuments[doc]) {
+                metaFile.write(reinterpret_cast<const char*>(&doc), sizeof(doc));
+            }
         }
         
+        // Titles, sources and dates
+        documentInfo.write(metaFile);
+        
         std::cout << "Indices saved successfully." << std::endl;
     }
     catch (const std::exception& e) {
@@ -113,16 +710,29 @@ void IndexHandler::saveIndices(const std::string& basePath) const {
 
 void IndexHandler::loadIndices(const std::string& basePath) {
     std::cout << "Loading indices from " << basePath << "..." << std::endl;
+    ++generation;
     
     try {
-        // Load word index
-        wordIndex.deserialize(basePath + ".words");
+        auto readPostings = [](std::ifstream& in, PostingList& postings) {
+            postings.read(in);
+        };
+        
+        // Load word index, discarding any unmerged runs
+        removeRuns();
+        wordIndexBytes = 0;
+        wordIndex.deserialize(basePath + ".words", readPostings);
         
-        // Load organization index
-        organizationIndex.deserialize(basePath + ".orgs");
+        // Load bigram pseudo-terms (absent in indexes built without positions)
+        if (std::filesystem::exists(basePath + ".bigrams")) {
+            bigramIndex.deserialize(basePath + ".bigrams", readPostings);
+        }
+        else {
+            bigramIndex.clear();
+        }
         
-        // Load person index
-        personIndex.deserialize(basePath + ".persons");
+        // Load entity dictionaries and postings
+        loadEntities(basePath + ".orgs", organizationNames, organizationPostings);
+        loadEntities(basePath + ".persons", personNames, personPostings);
         
         // Load document metadata
         std::ifstream metaFile(basePath + ".meta", std::ios::binary);
@@ -130,11 +740,24 @@ void IndexHandler::loadIndices(const std::string& basePath) {
             throw std::runtime_error("Failed to open metadata file for reading");
         }
         
+        uint32_t magic = 0, version = 0;
+        metaFile.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+        metaFile.read(reinterpret_cast<char*>(&version), sizeof(version));
+        if (magic != kMetaMagic || version != kMetaVersion) {
+            throw std::runtime_error("Unsupported index format in " + basePath + ".meta; rebuild the index");
+        }
+        
         size_t docCount;
         metaFile.read(reinterpret_cast<char*>(&docCount), sizeof(docCount));
         
         documentIDs.clear();
-        documentMetadata.clear();
+        documentOrdinals.clear();
+        documentInfo.clear();
+        documentLengths.clear();
+        totalDocumentLength = 0;
+        deletedDocuments.clear();
+        deletedCount = 0;
+        duplicateCount = 0;
         
         for (size_t i = 0; i < docCount; ++i) {
             size_t idSize;
@@ -143,17 +766,63 @@ void IndexHandler::loadIndices(const std::string& basePath) {
             std::string docID(idSize, ' ');
             metaFile.read(&docID[0], idSize);
             
-            size_t metaSize;
-            metaFile.read(reinterpret_cast<char*>(&metaSize), sizeof(metaSize));
+            uint32_t docLength;
+            metaFile.read(reinterpret_cast<char*>(&docLength), sizeof(docLength));
             
-            std::string metaStr(metaSize, ' ');
-            metaFile.read(&metaStr[0], metaSize);
-            
-            documentIDs.insert(docID);
-            documentMetadata[docID] = metaStr;
+            // A re-added ID appears again at a later ordinal, which wins
+            documentOrdinals[docID] = static_cast<uint32_t>(documentIDs.size());
+            documentIDs.push_back(std::move(docID));
+            documentLengths.push_back(docLength);
+            totalDocumentLength += docLength;
+        }
+        
+        // Indexes with positions keep recording them when documents are added
+        metaFile.read(reinterpret_cast<char*>(&storePositions), sizeof(storePositions));
+        
+        // Near-duplicate state
+        nearDuplicates.clear();
+        metaFile.read(reinterpret_cast<char*>(&detectDuplicates), sizeof(detectDuplicates));
+        
+        size_t fingerprintCount = 0;
+        metaFile.read(reinterpret_cast<char*>(&fingerprintCount), sizeof(fingerprintCount));
+        std::vector<uint64_t> fingerprints(metaFile ? fingerprintCount : 0);
+        metaFile.read(reinterpret_cast<char*>(fingerprints.data()), fingerprints.size() * sizeof(uint64_t));
+        for (size_t doc = 0; doc < fingerprints.size(); ++doc) {
+            nearDuplicates.insert(static_cast<uint32_t>(doc), fingerprints[doc]);
+        }
+        
+        size_t duplicateCount = 0;
+        metaFile.read(reinterpret_cast<char*>(&duplicateCount), sizeof(duplicateCount));
+        for (size_t i = 0; metaFile && i < duplicateCount; ++i) {
+            size_t idSize = 0;
+            metaFile.read(reinterpret_cast<char*>(&idSize), sizeof(idSize));
+            std::string docID(idSize, ' ');
+            metaFile.read(&docID[0], idSize);
+            uint32_t doc = 0;
+            metaFile.read(reinterpret_cast<char*>(&doc), sizeof(doc));
+            addDuplicate(docID, doc);
+        }
+        
+        // Tombstones, replayed once titles, sources and dates are loaded
+        size_t tombstones = 0;
+        metaFile.read(reinterpret_cast<char*>(&tombstones), sizeof(tombstones));
+        std::vector<uint32_t> deleted(metaFile ? tombstones : 0);
+        metaFile.read(reinterpret_cast<char*>(deleted.data()), deleted.size() * sizeof(uint32_t));
+        documentInfo.read(metaFile);
+        if (!metaFile) {
+            throw std::runtime_error("Truncated metadata file");
         }
+        deleteDocuments(deleted);
         
-        std::cout << "Loaded " << documentIDs.size() << " documents." << std::endl;
+        buildScoreBounds();
+        buildWordTrie();
+        
+        // The saved bigram index matches the saved postings
+        bigramCounts.clear();
+        bigramCountFloor = 0;
+        bigramsCurrent = true;
+        
+        std::cout << "Loaded " << getTotalDocuments() << " documents." << std::endl;
     }
     catch (const std::exception& e) {
         std::cerr << "Error loading indices: " << e.what() << std::endl;
@@ -161,14 +830,114 @@ void IndexHandler::loadIndices(const std::string& basePath) {
     }
 }
 
-std::vector<std::pair<std::string, double>> IndexHandler::searchWord(const std::string& term) const {
-    return wordIndex.search(term);
+const PostingList* IndexHandler::getWordPostings(const std::string& term) const {
+    return wordIndex.find(term);
+}
+
+std::vector<std::string> IndexHandler::findSimilarWords(const std::string& term, uint32_t maxEdits,
+                                                       size_t limit) const {
+    LevenshteinAutomaton automaton(term, maxEdits);
+    std::vector<std::pair<std::string, uint32_t>> found;
+    
+    if (wordTrieGeneration == generation) {
+        found = wordTrie.match(automaton);
+    }
+    else {
+        std::string prefix;
+        
+        // Visit the words under prefix, which leads to state.
+        // Keys never contain '\0', so prefix + '\0' bounds the longer words below.
+        auto walk = [&](auto& self, uint32_t state) -> void {
+            std::string probe = prefix + '\0';
+            
+            while (const std::string* key = wordIndex.lowerBound(probe)) {
+                if (key->size() <= prefix.size() || key->compare(0, prefix.size(), prefix) != 0) {
+                    break;
+                }
+                unsigned char c = static_cast<unsigned char>((*key)[prefix.size()]);
+                uint32_t next = automaton.step(state, c);
+                if (automaton.canMatch(next)) {
+                    prefix.push_back(static_cast<char>(c));
+                    // The smallest word with the new prefix is the prefix itself, if indexed
+                    if (key->size() == prefix.size() && automaton.distance(next) <= automaton.getMaxEdits()) {
+                        found.emplace_back(*key, automaton.distance(next));
+                    }
+                    self(self, next);
+                    prefix.pop_back();
+                }
+                
+                // Skip every word that continues with c
+                if (c == 0xff) {
+                    break;
+                }
+                probe = prefix;
+                probe.push_back(static_cast<char>(c + 1));
+            }
+        };
+        walk(walk, automaton.start());
+    }
+    
+    struct Match {
+        uint32_t distance;
+        size_t documentFrequency;
+        std::string word;
+    };
+    std::vector<Match> matches;
+    matches.reserve(found.size());
+    for (auto& [word, distance] : found) {
+        size_t documentFrequency = wordIndex.find(word)->documentFrequency();
+        matches.push_back({distance, documentFrequency, std::move(word)});
+    }
+    
+    std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        if (a.distance != b.distance) return a.distance < b.distance;
+        if (a.documentFrequency != b.documentFrequency) return a.documentFrequency > b.documentFrequency;
+        return a.word < b.word;
+    });
+    
+    std::vector<std::string> words;
+    for (size_t i = 0; i < matches.size() && i < limit; ++i) {
+        words.push_back(std::move(matches[i].word));
+    }
+    return words;
+}
+
+const PostingList* IndexHandler::getOrganizationPostings(std::string_view org) const {
+    uint32_t id = organizationNames.lookup(org);
+    return id < organizationPostings.size() ? &organizationPostings[id] : nullptr;
 }
 
-std::vector<std::pair<std::string, double>> IndexHandler::searchOrganization(const std::string& org) const {
-    return organizationIndex.search(org);
+const PostingList* IndexHandler::getPersonPostings(std::string_view person) const {
+    uint32_t id = personNames.lookup(person);
+    return id < personPostings.size() ? &personPostings[id] : nullptr;
 }
 
-std::vector<std::pair<std::string, double>> IndexHandler::searchPerson(const std::string& person) const {
-    return personIndex.search(person);
-}
\ No newline at end of file
+void IndexHandler::saveEntities(const std::string& filename, const EntityDictionary& names,
+                                const std::vector<PostingList>& postings) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open file for writing: " + filename);
+    }
+    
+    names.write(file);
+    for (size_t id = 0; id < names.size(); ++id) {
+        postings[id].write(file);
+    }
+}
+
+void IndexHandler::loadEntities(const std::string& filename, EntityDictionary& names,
+                                std::vector<PostingList>& postings) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open file for reading: " + filename);
+    }
+    
+    names.read(file);
+    postings.assign(names.size(), PostingList());
+    for (auto& list : postings) {
+        list.read(file);
+    }
+    if (!file) {
+        throw std::runtime_error("Truncated entity index: " + filename);
+    }
+}
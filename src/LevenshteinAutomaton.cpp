@@ -0,0 +1,61 @@
+/**
+ * @file LevenshteinAutomaton.cpp
+ * @author <YourName>
+ * @brief Implementation of the Levenshtein automaton
+ */
+
+#include "../include/LevenshteinAutomaton.h"
+#include <algorithm>
+
+LevenshteinAutomaton::LevenshteinAutomaton(std::string_view term, uint32_t maxEdits)
+    : term(term), maxEdits(static_cast<uint8_t>(std::min(maxEdits, kMaxEdits))) {
+    for (unsigned char c : this->term) {
+        if (!classOf[c]) {
+            classOf[c] = static_cast<uint8_t>(classCount++);
+        }
+    }
+    
+    // Matching the empty input against a prefix of length i takes i deletions
+    const char cap = static_cast<char>(this->maxEdits + 1);
+    std::string row(this->term.size() + 1, cap);
+    for (size_t i = 0; i < row.size() && i <= this->maxEdits; ++i) {
+        row[i] = static_cast<char>(i);
+    }
+    intern(std::move(row));
+    intern(std::string(this->term.size() + 1, cap));
+    std::fill(transitions.begin() + kDead * classCount, transitions.end(), kDead);
+}
+
+uint32_t LevenshteinAutomaton::intern(std::string row) {
+    auto [it, added] = states.emplace(row, static_cast<uint32_t>(rows.size()));
+    if (added) {
+        rows.push_back(std::move(row));
+        transitions.resize(rows.size() * classCount, kUnknown);
+    }
+    return it->second;
+}
+
+uint32_t LevenshteinAutomaton::step(uint32_t state, unsigned char c) {
+    const size_t slot = state * classCount + classOf[c];
+    if (transitions[slot] != kUnknown) {
+        return transitions[slot];
+    }
+    
+    const uint8_t cap = maxEdits + 1;
+    const std::string& row = rows[state];
+    std::string next(row.size(), 0);
+    next[0] = static_cast<char>(std::min<uint8_t>(static_cast<uint8_t>(row[0]) + 1, cap));
+    uint8_t smallest = static_cast<uint8_t>(next[0]);
+    for (size_t i = 1; i <= term.size(); ++i) {
+        uint8_t substitute = static_cast<uint8_t>(row[i - 1]) + (static_cast<unsigned char>(term[i - 1]) == c ? 0 : 1);
+        uint8_t insert = static_cast<uint8_t>(row[i]) + 1;
+        uint8_t remove = static_cast<uint8_t>(next[i - 1]) + 1;
+        uint8_t value = std::min({substitute, insert, remove, cap});
+        next[i] = static_cast<char>(value);
+        smallest = std::min(smallest, value);
+    }
+    
+    uint32_t target = smallest > maxEdits ? kDead : intern(std::move(next));
+    transitions[slot] = target;
+    return target;
+}
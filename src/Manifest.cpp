@@ -0,0 +1,117 @@
+/**
+ * @file Manifest.cpp
+ * @author <YourName>
+ * @brief Implementation of the index file manifest
+ */
+
+#include "../include/Manifest.h"
+#include "../include/SimHash.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'S', 'M', 'A', 'N', 'I', 'F', '1'};
+
+std::string canonicalRoot(const std::string& root) {
+    return std::filesystem::weakly_canonical(root).string();
+}
+
+} // namespace
+
+uint64_t Manifest::hashContent(std::string_view data) {
+    return SimHash::hash(data);
+}
+
+void Manifest::reset(const std::string& root, bool storePositions, bool detectDuplicates) {
+    this->root = canonicalRoot(root);
+    this->storePositions = storePositions;
+    this->detectDuplicates = detectDuplicates;
+    entries.clear();
+}
+
+bool Manifest::matches(const std::string& root, bool storePositions, bool detectDuplicates) const {
+    return !this->root.empty() && this->root == canonicalRoot(root) &&
+           this->storePositions == storePositions && this->detectDuplicates == detectDuplicates;
+}
+
+bool Manifest::load(const std::string& filename) {
+    root.clear();
+    entries.clear();
+    
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(kMagic)] = {};
+    if (!file || !file.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    
+    auto readString = [&file](std::string& value) {
+        size_t size = 0;
+        file.read(reinterpret_cast<char*>(&size), sizeof(size));
+        value.assign(file ? size : 0, ' ');
+        file.read(&value[0], static_cast<std::streamsize>(value.size()));
+    };
+    
+    readString(root);
+    file.read(reinterpret_cast<char*>(&storePositions), sizeof(storePositions));
+    file.read(reinterpret_cast<char*>(&detectDuplicates), sizeof(detectDuplicates));
+    size_t count = 0;
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    
+    std::string path;
+    for (size_t i = 0; i < count && file; ++i) {
+        readString(path);
+        Entry entry;
+        file.read(reinterpret_cast<char*>(&entry.size), sizeof(entry.size));
+        file.read(reinterpret_cast<char*>(&entry.modified), sizeof(entry.modified));
+        file.read(reinterpret_cast<char*>(&entry.hash), sizeof(entry.hash));
+        file.read(reinterpret_cast<char*>(&entry.doc), sizeof(entry.doc));
+        entries.emplace(path, entry);
+    }
+    
+    if (!file) {
+        root.clear();
+        entries.clear();
+        return false;
+    }
+    return true;
+}
+
+void Manifest::save(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open manifest for writing: " + filename);
+    }
+    
+    auto writeString = [&file](const std::string& value) {
+        size_t size = value.size();
+        file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        file.write(value.data(), static_cast<std::streamsize>(size));
+    };
+    
+    file.write(kMagic, sizeof(kMagic));
+    writeString(root);
+    file.write(reinterpret_cast<const char*>(&storePositions), sizeof(storePositions));
+    file.write(reinterpret_cast<const char*>(&detectDuplicates), sizeof(detectDuplicates));
+    size_t count = entries.size();
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    
+    for (const auto& [path, entry] : entries) {
+        writeString(path);
+        file.write(reinterpret_cast<const char*>(&entry.size), sizeof(entry.size));
+        file.write(reinterpret_cast<const char*>(&entry.modified), sizeof(entry.modified));
+        file.write(reinterpret_cast<const char*>(&entry.hash), sizeof(entry.hash));
+        file.write(reinterpret_cast<const char*>(&entry.doc), sizeof(entry.doc));
+    }
+    
+    if (!file) {
+        throw std::runtime_error("Failed to write manifest: " + filename);
+    }
+}
+
+const Manifest::Entry* Manifest::find(const std::string& path) const {
+    auto it = entries.find(path);
+    return it != entries.end() ? &it->second : nullptr;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file PostingIntersection.cpp
+ * @author <YourName>
+ * @brief Implementation of galloping and SIMD block intersection
+ */
+
+#include "../include/PostingIntersection.h"
+#include <algorithm>
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define INTERSECTION_SSE2 1
+#include <emmintrin.h>
+#endif
+
+size_t gallopTo(const std::vector<Posting>& postings, size_t from, uint32_t doc) {
+    size_t size = postings.size();
+    if (from >= size || postings[from].doc >= doc) {
+        return from;
+    }
+    
+    // postings[low].doc < doc throughout; the answer lies in (low, high]
+    size_t low = from;
+    size_t step = 1;
+    size_t high = from + step;
+    while (high < size && postings[high].doc < doc) {
+        low = high;
+        step <<= 1;
+        high = from + step;
+    }
+    high = std::min(high + 1, size);
+    
+    auto it = std::lower_bound(postings.begin() + low + 1, postings.begin() + high, doc,
+                               [](const Posting& posting, uint32_t d) { return posting.doc < d; });
+    return static_cast<size_t>(it - postings.begin());
+}
+
+void intersectGalloping(std::vector<uint32_t>& docs, const std::vector<Posting>& postings) {
+    size_t kept = 0;
+    size_t index = 0;
+    for (size_t i = 0; i < docs.size(); ++i) {
+        index = gallopTo(postings, index, docs[i]);
+        if (index == postings.size()) {
+            break;
+        }
+        if (postings[index].doc == docs[i]) {
+            docs[kept++] = docs[i];
+        }
+    }
+    docs.resize(kept);
+}
+
+void intersectMerge(std::vector<uint32_t>& docs, const std::vector<Posting>& postings) {
+    size_t i = 0;
+    size_t j = 0;
+    size_t kept = 0;
+    size_t docCount = docs.size();
+    size_t postingCount = postings.size();
+
+#ifdef INTERSECTION_SSE2
+    static_assert(sizeof(Posting) == 8, "the block kernel loads postings as (doc, tf) pairs");
+    alignas(16) uint32_t block[4];
+    
+    while (i + 4 <= docCount && j + 4 <= postingCount) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(docs.data() + i));
+        __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(postings.data() + j));
+        __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(postings.data() + j + 2));
+        __m128i b = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(low), _mm_castsi128_ps(high),
+                                                    _MM_SHUFFLE(2, 0, 2, 0)));
+        
+        // Compare every document with every posting by rotating the postings
+        __m128i equal = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(a, b), _mm_cmpeq_epi32(a, _mm_shuffle_epi32(b, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm_or_si128(_mm_cmpeq_epi32(a, _mm_shuffle_epi32(b, _MM_SHUFFLE(1, 0, 3, 2))),
+                         _mm_cmpeq_epi32(a, _mm_shuffle_epi32(b, _MM_SHUFFLE(2, 1, 0, 3)))));
+        unsigned matches = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(equal)));
+        
+        uint32_t lastDoc = docs[i + 3];
+        uint32_t lastPosting = postings[j + 3].doc;
+        if (matches) {
+            _mm_store_si128(reinterpret_cast<__m128i*>(block), a);
+            for (; matches; matches &= matches - 1) {
+                docs[kept++] = block[std::countr_zero(matches)];
+            }
+        }
+        
+        // Skip whichever block cannot match anything further (both if they end alike)
+        if (lastDoc <= lastPosting) {
+            i += 4;
+        }
+        if (lastPosting <= lastDoc) {
+            j += 4;
+        }
+    }
+#endif
+
+    while (i < docCount && j < postingCount) {
+        if (docs[i] < postings[j].doc) {
+            ++i;
+        }
+        else if (postings[j].doc < docs[i]) {
+            ++j;
+        }
+        else {
+            docs[kept++] = docs[i];
+            ++i;
+            ++j;
+        }
+    }
+    docs.resize(kept);
+}
+
+void intersectPostings(std::vector<uint32_t>& docs, const std::vector<Posting>& postings) {
+    if (docs.size() * kGallopRatio < postings.size()) {
+        intersectGalloping(docs, postings);
+    }
+    else {
+        intersectMerge(docs, postings);
+    }
+}
+
+void subtractPostings(std::vector<uint32_t>& docs, const std::vector<Posting>& postings) {
+    size_t kept = 0;
+    size_t index = 0;
+    for (size_t i = 0; i < docs.size(); ++i) {
+        index = gallopTo(postings, index, docs[i]);
+        if (index == postings.size() || postings[index].doc != docs[i]) {
+            docs[kept++] = docs[i];
+        }
+    }
+    docs.resize(kept);
+}
@@ -0,0 +1,200 @@
+/**
+ * @file PostingIterator.cpp
+ * @author <YourName>
+ * @brief Implementation of the boolean query iterators
+ */
+
+#include "../include/PostingIterator.h"
+#include "../include/PostingIntersection.h"
+#include "../include/QueryProcessor.h"
+#include <algorithm>
+
+ListIterator::ListIterator(const PostingList& list, const IndexHandler& index, double idf, double avgLength)
+    : postings(list.postings), index(&index), idf(idf), avgLength(avgLength) {
+    current = postings.empty() ? kEnd : postings.front().doc;
+}
+
+ListIterator::ListIterator(const PostingList& list, double boost)
+    : postings(list.postings), boost(boost) {
+    current = postings.empty() ? kEnd : postings.front().doc;
+}
+
+uint32_t ListIterator::next() {
+    if (current == kEnd) {
+        return kEnd;
+    }
+    ++position;
+    return current = position < postings.size() ? postings[position].doc : kEnd;
+}
+
+uint32_t ListIterator::advance(uint32_t target) {
+    if (target <= current) {
+        return current;
+    }
+    position = gallopTo(postings, position, target);
+    return current = position < postings.size() ? postings[position].doc : kEnd;
+}
+
+double ListIterator::score() const {
+    if (!index) {
+        return boost;
+    }
+    const Posting& posting = postings[position];
+    return QueryProcessor::bm25(posting.tf, index->getDocumentLength(posting.doc), idf, avgLength);
+}
+
+AndIterator::AndIterator(std::vector<PostingIteratorPtr> children) : children(std::move(children)) {
+    for (const auto& child : this->children) {
+        byCost.push_back(child.get());
+    }
+    std::stable_sort(byCost.begin(), byCost.end(), [](const PostingIterator* a, const PostingIterator* b) {
+        return a->cost() < b->cost();
+    });
+    current = align(byCost.front()->doc());
+}
+
+uint32_t AndIterator::align(uint32_t target) {
+    while (target != kEnd) {
+        target = byCost.front()->advance(target);
+        bool agreed = true;
+        for (size_t i = 1; i < byCost.size() && target != kEnd; ++i) {
+            uint32_t doc = byCost[i]->advance(target);
+            if (doc != target) {
+                // The rarest child proposes again from the later document
+                target = doc;
+                agreed = false;
+                break;
+            }
+        }
+        if (agreed) {
+            return target;
+        }
+    }
+    return kEnd;
+}
+
+uint32_t AndIterator::next() {
+    if (current == kEnd) {
+        return kEnd;
+    }
+    return current = align(byCost.front()->next());
+}
+
+uint32_t AndIterator::advance(uint32_t target) {
+    if (target <= current) {
+        return current;
+    }
+    return current = align(target);
+}
+
+double AndIterator::score() const {
+    double total = 0.0;
+    for (const auto& child : children) {
+        total += child->score();
+    }
+    return total;
+}
+
+OrIterator::OrIterator(std::vector<PostingIteratorPtr> children) : children(std::move(children)) {
+    current = smallest();
+}
+
+uint32_t OrIterator::smallest() const {
+    uint32_t doc = kEnd;
+    for (const auto& child : children) {
+        doc = std::min(doc, child->doc());
+    }
+    return doc;
+}
+
+uint32_t OrIterator::next() {
+    if (current == kEnd) {
+        return kEnd;
+    }
+    for (auto& child : children) {
+        if (child->doc() == current) {
+            child->next();
+        }
+    }
+    return current = smallest();
+}
+
+uint32_t OrIterator::advance(uint32_t target) {
+    if (target <= current) {
+        return current;
+    }
+    for (auto& child : children) {
+        child->advance(target);
+    }
+    return current = smallest();
+}
+
+double OrIterator::score() const {
+    double total = 0.0;
+    for (const auto& child : children) {
+        if (child->doc() == current) {
+            total += child->score();
+        }
+    }
+    return total;
+}
+
+size_t OrIterator::cost() const {
+    size_t total = 0;
+    for (const auto& child : children) {
+        total += child->cost();
+    }
+    return total;
+}
+
+AndNotIterator::AndNotIterator(PostingIteratorPtr include, PostingIteratorPtr exclude)
+    : include(std::move(include)), exclude(std::move(exclude)) {
+    current = skipExcluded(this->include->doc());
+}
+
+uint32_t AndNotIterator::skipExcluded(uint32_t doc) {
+    while (doc != kEnd && exclude->advance(doc) == doc) {
+        doc = include->next();
+    }
+    return doc;
+}
+
+uint32_t AndNotIterator::next() {
+    if (current == kEnd) {
+        return kEnd;
+    }
+    return current = skipExcluded(include->next());
+}
+
+uint32_t AndNotIterator::advance(uint32_t target) {
+    if (target <= current) {
+        return current;
+    }
+    return current = skipExcluded(include->advance(target));
+}
+
+FilterIterator::FilterIterator(PostingIteratorPtr child, std::function<bool(uint32_t)> accept)
+    : child(std::move(child)), accept(std::move(accept)) {
+    current = skipRejected(this->child->doc());
+}
+
+uint32_t FilterIterator::skipRejected(uint32_t doc) {
+    while (doc != kEnd && !accept(doc)) {
+        doc = child->next();
+    }
+    return doc;
+}
+
+uint32_t FilterIterator::next() {
+    if (current == kEnd) {
+        return kEnd;
+    }
+    return current = skipRejected(child->next());
+}
+
+uint32_t FilterIterator::advance(uint32_t target) {
+    if (target <= current) {
+        return current;
+    }
+    return current = skipRejected(child->advance(target));
+}
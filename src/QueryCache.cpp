@@ -0,0 +1,102 @@
+/**
+ * @file QueryCache.cpp
+ * @author <YourName>
+ * @brief Implementation of the query result cache
+ */
+
+#include "../include/QueryCache.h"
+#include <algorithm>
+
+namespace {
+
+// List node, map node and bucket pointer around each entry
+constexpr size_t kEntryOverhead = 128;
+
+} // namespace
+
+QueryCache::QueryCache(size_t capacityBytes)
+    : shardCapacity(std::max<size_t>(1, capacityBytes / kShardCount)) {
+}
+
+size_t QueryCache::entryBytes(const Entry& entry) {
+    return kEntryOverhead + entry.key.capacity() +
+           entry.documents.capacity() * sizeof(RankedDocuments::value_type);
+}
+
+void QueryCache::erase(Shard& shard, EntryList::iterator entry) {
+    shard.bytes -= entry->bytes;
+    shard.index.erase(entry->key);
+    shard.entries.erase(entry);
+}
+
+bool QueryCache::find(const std::string& key, uint64_t generation, RankedDocuments& documents) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        if (it->second->generation == generation) {
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            documents = it->second->documents;
+            ++shard.hits;
+            return true;
+        }
+        erase(shard, it->second);
+        ++shard.invalidations;
+    }
+    ++shard.misses;
+    return false;
+}
+
+void QueryCache::insert(const std::string& key, uint64_t generation, const RankedDocuments& documents) {
+    Entry entry{key, generation, documents, 0};
+    entry.bytes = entryBytes(entry);
+    size_t bytes = entry.bytes;
+    if (bytes > shardCapacity) {
+        return;
+    }
+    
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    
+    // Another thread may have computed the same query meanwhile
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        if (it->second->generation > generation) {
+            return;
+        }
+        erase(shard, it->second);
+    }
+    
+    while (!shard.entries.empty() && shard.bytes + bytes > shardCapacity) {
+        erase(shard, std::prev(shard.entries.end()));
+        ++shard.evictions;
+    }
+    
+    shard.entries.push_front(std::move(entry));
+    shard.index.emplace(shard.entries.front().key, shard.entries.begin());
+    shard.bytes += bytes;
+}
+
+void QueryCache::clear() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        shard.entries.clear();
+        shard.bytes = 0;
+    }
+}
+
+QueryCache::Stats QueryCache::getStats() const {
+    Stats stats;
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.hits += shard.hits;
+        stats.misses += shard.misses;
+        stats.invalidations += shard.invalidations;
+        stats.evictions += shard.evictions;
+        stats.entries += shard.entries.size();
+        stats.bytes += shard.bytes;
+    }
+    return stats;
+}
@@ -5,148 +5,1181 @@
  */
 
 #include "../include/QueryProcessor.h"
-#include <sstream>
+#include "../include/StemCache.h"
+#include "../include/PostingIntersection.h"
+#include "../include/PostingIterator.h"
+#include "../include/LevenshteinAutomaton.h"
 #include <algorithm>
+#include <cctype>
 #include <cmath>
-#include "../thirdparty/porter2_stemmer/thirdparty/porter2_stemmer/porter2_stemmer.h"
-#include "../thirdparty/rapidjson/include/rapidjson/document.h"
-
-std::tuple<std::vector<std::string>, std::vector<std::string>, 
-          std::vector<std::string>, std::vector<std::string>> 
-QueryProcessor::parseQuery(const std::string& query) {
-    std::vector<std::string> terms, orgs, persons, exclusions;
-    std::istringstream iss(query);
-    std::string token;
-    
-    while (iss >> token) {
-        // Process special operator prefixes
-        if (token.size() >= 5 && token.substr(0, 4) == "ORG:") {
-            orgs.push_back(token.substr(4));
-        } 
-        else if (token.size() >= 8 && token.substr(0, 7) == "PERSON:") {
-            persons.push_back(token.substr(7));
-        }
-        else if (!token.empty() && token[0] == '-' && token.size() > 1) {
-            // Exclusion terms
-            std::string term = token.substr(1);
-            std::transform(term.begin(), term.end(), term.begin(), 
-                          [](unsigned char c) { return std::tolower(c); });
-            Porter2Stemmer::stem(term);
-            exclusions.push_back(term);
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+constexpr double kEntityBoost = 1.5;               // score added per matching ORG:/PERSON:
+constexpr double kBoundSlack = 1.0 + 1e-9;         // keeps bounds above rounding in scores
+constexpr uint32_t kNoMoreDocuments = UINT32_MAX;  // document of an exhausted cursor
+constexpr size_t kFuzzyExpansions = 50;            // words a word~N may stand for
+
+// Higher score first; equal scores in ordinal (ingestion) order so the
+// ranking does not depend on hash map iteration order
+bool rankedBefore(const std::pair<double, uint32_t>& a, const std::pair<double, uint32_t>& b) {
+    return a.first > b.first || (a.first == b.first && a.second < b.second);
+}
+
+// Keep the best `limit` documents in a heap whose top is the worst of them,
+// so each further document costs one comparison unless it displaces it
+void offerResult(std::vector<std::pair<double, uint32_t>>& top, size_t limit, double score, uint32_t doc) {
+    if (top.size() < limit) {
+        top.emplace_back(score, doc);
+        std::push_heap(top.begin(), top.end(), rankedBefore);
+    }
+    else if (limit > 0 && rankedBefore({score, doc}, top.front())) {
+        std::pop_heap(top.begin(), top.end(), rankedBefore);
+        top.back() = {score, doc};
+        std::push_heap(top.begin(), top.end(), rankedBefore);
+    }
+}
+
+} // namespace
+
+std::vector<QueryProcessor::QueryToken> QueryProcessor::lexQuery(const std::string& query) {
+    std::vector<QueryToken> tokens;
+    size_t pos = 0;
+    
+    auto isSpace = [](char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; };
+    
+    while (pos < query.size()) {
+        char c = query[pos];
+        if (isSpace(c)) {
+            ++pos;
+        }
+        else if (c == '(' || c == ')') {
+            tokens.push_back({c == '(' ? QueryToken::Kind::Open : QueryToken::Kind::Close, {}, 0});
+            ++pos;
+        }
+        else if (c == '-' && pos + 1 < query.size() && !isSpace(query[pos + 1])) {
+            // Negates whatever follows: a word, field, phrase or group
+            tokens.push_back({QueryToken::Kind::Minus, {}, 0});
+            ++pos;
+        }
+        else if (c == '"') {
+            // Quoted phrase, optionally followed by ~N for proximity
+            size_t close = query.find('"', pos + 1);
+            if (close == std::string::npos) {
+                close = query.size();
+            }
+            QueryToken phrase{QueryToken::Kind::Phrase, query.substr(pos + 1, close - pos - 1), 0};
+            pos = std::min(close + 1, query.size());
+            if (pos < query.size() && query[pos] == '~') {
+                ++pos;
+                while (pos < query.size() && std::isdigit(static_cast<unsigned char>(query[pos]))) {
+                    phrase.slop = phrase.slop * 10 + static_cast<uint32_t>(query[pos] - '0');
+                    ++pos;
+                }
+            }
+            tokens.push_back(std::move(phrase));
         }
         else {
-            // Regular search terms
-            std::transform(token.begin(), token.end(), token.begin(), 
-                          [](unsigned char c) { return std::tolower(c); });
-            Porter2Stemmer::stem(token);
-            terms.push_back(token);
+            size_t end = pos;
+            while (end < query.size() && !isSpace(query[end]) && query[end] != '(' && query[end] != ')' &&
+                   query[end] != '"') {
+                ++end;
+            }
+            tokens.push_back({QueryToken::Kind::Word, query.substr(pos, end - pos), 0});
+            pos = end;
         }
     }
+    return tokens;
+}
+
+std::optional<QueryNode> QueryProcessor::parseQuery(const std::string& query,
+                                                    std::vector<std::string>& droppedStopwords) {
+    std::vector<QueryToken> tokens = lexQuery(query);
+    QueryNode root;
+    root.type = QueryNode::Type::And;
     
-    return {terms, orgs, persons, exclusions};
+    // A stray ')' ends a group that was never opened; parsing resumes after it
+    size_t pos = 0;
+    while (pos < tokens.size()) {
+        if (auto node = parseDisjunction(tokens, pos, droppedStopwords)) {
+            root.children.push_back(std::move(*node));
+        }
+        if (pos < tokens.size()) {
+            ++pos;
+        }
+    }
+    return combine(std::move(root));
 }
 
-void QueryProcessor::applyExclusions(std::unordered_map<std::string, double>& results, 
-                                   const std::vector<std::string>& exclusions) {
-    for (const auto& term : exclusions) {
-        auto excludeDocs = indexHandler.searchWord(term);
-        for (const auto& [docID, _] : excludeDocs) {
-            results.erase(docID);
+std::optional<QueryNode> QueryProcessor::parseDisjunction(const std::vector<QueryToken>& tokens, size_t& pos,
+                                                          std::vector<std::string>& dropped) {
+    QueryNode node;
+    node.type = QueryNode::Type::Or;
+    while (true) {
+        if (auto operand = parseConjunction(tokens, pos, dropped)) {
+            node.children.push_back(std::move(*operand));
         }
+        if (pos < tokens.size() && tokens[pos].kind == QueryToken::Kind::Word && tokens[pos].text == "OR") {
+            ++pos;
+            continue;
+        }
+        return combine(std::move(node));
     }
 }
 
-std::vector<QueryResult> QueryProcessor::processQuery(const std::string& query) {
-    auto [terms, orgs, persons, exclusions] = parseQuery(query);
+std::optional<QueryNode> QueryProcessor::parseConjunction(const std::vector<QueryToken>& tokens, size_t& pos,
+                                                          std::vector<std::string>& dropped) {
+    QueryNode node;
+    node.type = QueryNode::Type::And;
+    while (pos < tokens.size() && tokens[pos].kind != QueryToken::Kind::Close) {
+        const QueryToken& token = tokens[pos];
+        if (token.kind == QueryToken::Kind::Word && token.text == "OR") {
+            break;
+        }
+        if (token.kind == QueryToken::Kind::Word && token.text == "AND") {
+            ++pos;
+            continue;
+        }
+        if (auto operand = parseUnary(tokens, pos, dropped)) {
+            node.children.push_back(std::move(*operand));
+        }
+    }
+    return combine(std::move(node));
+}
+
+std::optional<QueryNode> QueryProcessor::parseUnary(const std::vector<QueryToken>& tokens, size_t& pos,
+                                                    std::vector<std::string>& dropped) {
+    const QueryToken& token = tokens[pos];
+    if (token.kind == QueryToken::Kind::Minus || (token.kind == QueryToken::Kind::Word && token.text == "NOT")) {
+        ++pos;
+        if (pos == tokens.size() || tokens[pos].kind == QueryToken::Kind::Close) {
+            return std::nullopt;
+        }
+        auto operand = parseUnary(tokens, pos, dropped);
+        if (!operand) {
+            return std::nullopt;
+        }
+        QueryNode node;
+        node.type = QueryNode::Type::Not;
+        node.children.push_back(std::move(*operand));
+        return node;
+    }
+    return parsePrimary(tokens, pos, dropped);
+}
+
+std::optional<QueryNode> QueryProcessor::parsePrimary(const std::vector<QueryToken>& tokens, size_t& pos,
+                                                      std::vector<std::string>& dropped) {
+    const QueryToken& token = tokens[pos++];
+    QueryNode node;
+    
+    switch (token.kind) {
+        case QueryToken::Kind::Open: {
+            auto group = parseDisjunction(tokens, pos, dropped);
+            if (pos < tokens.size()) {
+                ++pos;  // the closing parenthesis (optional at the end of the query)
+            }
+            return group;
+        }
+        case QueryToken::Kind::Phrase: {
+            ParsedQuery phrase;
+            addPhrase(token.text, token.slop, phrase);
+            if (!phrase.phrases.empty()) {
+                node.type = QueryNode::Type::Phrase;
+                node.phrase = std::move(phrase.phrases.front());
+                return node;
+            }
+            if (phrase.terms.empty()) {
+                return std::nullopt;
+            }
+            // A single remaining word is just a word
+            node.type = QueryNode::Type::Word;
+            node.value = std::move(phrase.terms.front());
+            return node;
+        }
+        case QueryToken::Kind::Word:
+            break;
+        default:
+            return std::nullopt;
+    }
+    
+    const std::string& text = token.text;
+    if (text.size() >= 5 && text.compare(0, 4, "ORG:") == 0) {
+        node.type = QueryNode::Type::Organization;
+        node.value = EntityDictionary::normalize(std::string_view(text).substr(4));
+        return node;
+    }
+    if (text.size() >= 8 && text.compare(0, 7, "PERSON:") == 0) {
+        node.type = QueryNode::Type::Person;
+        node.value = EntityDictionary::normalize(std::string_view(text).substr(7));
+        return node;
+    }
+    
+    // word~1, word~2 and word~ (meaning ~2): any indexed word within that many
+    // edits. Any other suffix leaves the token a plain word.
+    uint32_t edits = 0;
+    std::string_view word = text;
+    size_t tilde = text.rfind('~');
+    if (tilde != std::string::npos && tilde > 0) {
+        std::string_view suffix = word.substr(tilde + 1);
+        if (suffix.empty() || suffix == "2") {
+            edits = 2;
+        }
+        else if (suffix == "1") {
+            edits = 1;
+        }
+        if (edits > 0) {
+            word = word.substr(0, tilde);
+        }
+    }
+    
+    // Words are normalized exactly like indexed content; stopwords are never
+    // indexed, so they are dropped
+    std::string term = tokenizer.normalize(word);
+    if (term.empty()) {
+        return std::nullopt;
+    }
+    if (stopwords.contains(term)) {
+        dropped.push_back(term);
+        return std::nullopt;
+    }
+    StemCache::shared().stem(term);
+    node.type = QueryNode::Type::Word;
+    node.value = std::move(term);
+    if (edits == 0) {
+        return node;
+    }
+    
+    // The closest (then most frequent) words become alternatives; at least one
+    // character of the word is kept, so short words do not match everything
+    std::vector<std::string> similar = indexHandler.findSimilarWords(
+        node.value, std::min<uint32_t>(edits, static_cast<uint32_t>(node.value.size() - 1)), kFuzzyExpansions);
+    if (similar.empty()) {
+        return node;
+    }
+    QueryNode alternatives;
+    alternatives.type = QueryNode::Type::Or;
+    for (auto& match : similar) {
+        QueryNode alternative;
+        alternative.type = QueryNode::Type::Word;
+        alternative.value = std::move(match);
+        alternatives.children.push_back(std::move(alternative));
+    }
+    return combine(std::move(alternatives));
+}
+
+std::optional<QueryNode> QueryProcessor::combine(QueryNode node) {
+    // Nested operators of the same kind merge: a AND (b AND c) is a AND b AND c
+    std::vector<QueryNode> children;
+    for (auto& child : node.children) {
+        if (child.type == node.type) {
+            std::move(child.children.begin(), child.children.end(), std::back_inserter(children));
+        }
+        else {
+            children.push_back(std::move(child));
+        }
+    }
+    if (children.empty()) {
+        return std::nullopt;
+    }
+    if (children.size() == 1) {
+        return std::move(children.front());
+    }
+    node.children = std::move(children);
+    return node;
+}
+
+bool QueryProcessor::flattenQuery(const QueryNode& root, ParsedQuery& parsed) {
+    using Type = QueryNode::Type;
+    auto isEntity = [](const QueryNode& node) {
+        return node.type == Type::Organization || node.type == Type::Person;
+    };
+    auto isExclusion = [](const QueryNode& node) {
+        return node.type == Type::Not && node.children.front().type == Type::Word;
+    };
+    auto isOptional = [&isEntity](const QueryNode& node) {
+        return node.type == Type::Word || isEntity(node);
+    };
+    auto addOperand = [&parsed](const QueryNode& node) {
+        switch (node.type) {
+            case Type::Word: parsed.terms.push_back(node.value); break;
+            case Type::Organization: parsed.orgs.push_back(node.value); break;
+            case Type::Person: parsed.persons.push_back(node.value); break;
+            case Type::Phrase:
+                parsed.terms.insert(parsed.terms.end(), node.phrase.terms.begin(), node.phrase.terms.end());
+                parsed.phrases.push_back(node.phrase);
+                break;
+            case Type::Not: parsed.exclusions.push_back(node.children.front().value); break;
+            default: break;
+        }
+    };
+    
+    // The shapes the term-at-a-time paths handle: a conjunction of words,
+    // entities, phrases and word exclusions, or a disjunction of words and
+    // entities with optional word exclusions
+    const std::vector<QueryNode> single = {root};
+    const std::vector<QueryNode>& operands = root.type == Type::And ? root.children : single;
+    
+    const QueryNode* disjunction = nullptr;
+    for (const auto& operand : operands) {
+        if (operand.type == Type::Or && !disjunction &&
+            std::all_of(operand.children.begin(), operand.children.end(), isOptional)) {
+            disjunction = &operand;
+        }
+        else if (operand.type == Type::Or || operand.type == Type::And ||
+                 (operand.type == Type::Not && !isExclusion(operand))) {
+            return false;
+        }
+    }
+    if (disjunction) {
+        for (const auto& operand : operands) {
+            if (&operand != disjunction && !isExclusion(operand)) {
+                return false;
+            }
+        }
+        parsed.anyTerm = true;
+        for (const auto& child : disjunction->children) {
+            addOperand(child);
+        }
+    }
+    for (const auto& operand : operands) {
+        if (&operand != disjunction) {
+            addOperand(operand);
+        }
+    }
+    
+    // Canonical order: the same words in any order score identically and
+    // share a cache entry
+    std::sort(parsed.terms.begin(), parsed.terms.end());
+    std::sort(parsed.orgs.begin(), parsed.orgs.end());
+    std::sort(parsed.persons.begin(), parsed.persons.end());
+    std::sort(parsed.exclusions.begin(), parsed.exclusions.end());
+    parsed.exclusions.erase(std::unique(parsed.exclusions.begin(), parsed.exclusions.end()),
+                            parsed.exclusions.end());
+    return true;
+}
+
+std::string QueryProcessor::canonicalize(QueryNode& node) {
+    switch (node.type) {
+        case QueryNode::Type::Word: return "w:" + node.value;
+        case QueryNode::Type::Organization: return "o:" + node.value;
+        case QueryNode::Type::Person: return "p:" + node.value;
+        case QueryNode::Type::Phrase: {
+            ParsedQuery phrase;
+            phrase.phrases.push_back(node.phrase);
+            return "q:" + cacheKey(phrase);
+        }
+        case QueryNode::Type::Not: return "(NOT\x1f" + canonicalize(node.children.front()) + ")";
+        default: break;
+    }
+    
+    // Operands of AND and OR commute, so they are sorted by their own keys
+    std::vector<std::pair<std::string, QueryNode>> keyed;
+    for (auto& child : node.children) {
+        std::string key = canonicalize(child);
+        keyed.emplace_back(std::move(key), std::move(child));
+    }
+    std::sort(keyed.begin(), keyed.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    
+    std::string key = node.type == QueryNode::Type::And ? "(AND" : "(OR";
+    node.children.clear();
+    for (auto& [childKey, child] : keyed) {
+        key += '\x1f' + childKey;
+        node.children.push_back(std::move(child));
+    }
+    return key + ')';
+}
+
+std::string QueryProcessor::cacheKey(const ParsedQuery& parsed) {
+    // Sections separated by \x1e, items by \x1f
+    std::string key = parsed.anyTerm ? "OR" : "AND";
+    auto addSection = [&key](const std::vector<std::string>& items) {
+        key += '\x1e';
+        for (const auto& item : items) {
+            key += item;
+            key += '\x1f';
+        }
+    };
+    addSection(parsed.terms);
+    addSection(parsed.orgs);
+    addSection(parsed.persons);
+    addSection(parsed.exclusions);
+    for (const auto& phrase : parsed.phrases) {
+        addSection(phrase.terms);
+        for (uint32_t offset : phrase.offsets) {
+            key += std::to_string(offset) + ' ';
+        }
+        key += '~' + std::to_string(phrase.slop);
+    }
+    return key;
+}
+
+void QueryProcessor::addPhrase(std::string_view text, uint32_t slop, ParsedQuery& parsed) {
+    PhraseQuery phrase;
+    phrase.slop = slop;
+    
+    // Same tokenization as indexing, so offsets count the dropped stopwords too
+    const auto& tokens = tokenizer.tokenize(text);
+    uint32_t first = 0;
+    for (uint32_t position = 0; position < tokens.size(); ++position) {
+        if (stopwords.contains(tokens[position])) {
+            continue;
+        }
+        std::string term(tokens[position]);
+        StemCache::shared().stem(term);
+        
+        if (phrase.terms.empty()) {
+            first = position;
+        }
+        phrase.offsets.push_back(position - first);
+        phrase.terms.push_back(term);
+    }
+    
+    parsed.terms.insert(parsed.terms.end(), phrase.terms.begin(), phrase.terms.end());
+    if (phrase.terms.size() > 1) {
+        parsed.phrases.push_back(std::move(phrase));
+    }
+}
+
+QueryProcessor::PhrasePlan QueryProcessor::planPhrase(const PhraseQuery& phrase) const {
+    PhrasePlan plan;
+    plan.slop = phrase.slop;
+    
+    for (size_t t = 0; t < phrase.terms.size(); ++t) {
+        // Exact adjacent words that were indexed together collapse into one unit
+        if (phrase.slop == 0 && t + 1 < phrase.terms.size() && 
+            phrase.offsets[t + 1] == phrase.offsets[t] + 1) {
+            const PostingList* bigram = indexHandler.getBigramPostings(phrase.terms[t], phrase.terms[t + 1]);
+            if (bigram) {
+                plan.lists.push_back(bigram);
+                plan.offsets.push_back(phrase.offsets[t]);
+                plan.units.push_back(phrase.terms[t] + ' ' + phrase.terms[t + 1]);
+                ++t;
+                continue;
+            }
+        }
+        
+        const PostingList* list = indexHandler.getWordPostings(phrase.terms[t]);
+        if (!list) {
+            plan.empty = true;
+            return plan;
+        }
+        plan.positional = plan.positional && list->hasPositions();
+        plan.lists.push_back(list);
+        plan.offsets.push_back(phrase.offsets[t]);
+        plan.units.push_back(phrase.terms[t]);
+    }
+    return plan;
+}
+
+void QueryProcessor::applyPhrase(std::unordered_map<uint32_t, double>& results, const PhrasePlan& plan) {
+    if (plan.empty) {
+        results.clear();
+        return;
+    }
+    if (!plan.positional) {
+        return;
+    }
     
-    std::unordered_map<std::string, double> scores;
+    for (auto it = results.begin(); it != results.end(); ) {
+        bool matched = plan.lists.size() == 1 
+            ? plan.lists[0]->findDocument(it->first) != plan.lists[0]->postings.size()
+            : matchesPhrase(plan, it->first);
+        if (matched) {
+            ++it;
+        }
+        else {
+            it = results.erase(it);
+        }
+    }
+}
+
+bool QueryProcessor::matchesPhrase(const PhrasePlan& plan, uint32_t doc) {
+    const auto& lists = plan.lists;
+    phrasePositions.resize(lists.size());
+    for (size_t t = 0; t < lists.size(); ++t) {
+        size_t index = lists[t]->findDocument(doc);
+        if (index == lists[t]->postings.size()) {
+            return false;
+        }
+        lists[t]->decodePositions(index, phrasePositions[t]);
+    }
     
-    // Process regular terms (using AND semantics)
-    if (!terms.empty()) {
-        auto firstResults = indexHandler.searchWord(terms[0]);
+    // For each occurrence of the first unit, place every following unit at its
+    // earliest position not before where the phrase expects it. Earliest is
+    // optimal: a later choice only adds slack for this and all following units.
+    for (uint32_t start : phrasePositions[0]) {
+        uint32_t previous = start;
+        uint32_t slack = 0;
+        bool matched = true;
         
-        // Start with the first term's documents
-        for (const auto& [docID, score] : firstResults) {
-            scores[docID] = score;
+        for (size_t t = 1; t < lists.size(); ++t) {
+            uint32_t expected = previous + (plan.offsets[t] - plan.offsets[t - 1]);
+            const auto& positions = phrasePositions[t];
+            auto next = std::lower_bound(positions.begin(), positions.end(), expected);
+            if (next == positions.end()) {
+                // Later starts only expect later positions
+                return false;
+            }
+            slack += *next - expected;
+            if (slack > plan.slop) {
+                matched = false;
+                break;
+            }
+            previous = *next;
         }
         
-        // Apply AND semantics for additional terms
-        for (size_t i = 1; i < terms.size(); ++i) {
-            auto termResults = indexHandler.searchWord(terms[i]);
-            std::unordered_map<std::string, double> tempScores;
+        if (matched) {
+            return true;
+        }
+    }
+    return false;
+}
+
+double QueryProcessor::inverseDocumentFrequency(size_t docFreq) const {
+    double totalDocs = static_cast<double>(indexHandler.getTotalDocuments());
+    double df = static_cast<double>(docFreq);
+    // Clamped so that a stale df above N cannot make the weight negative, which
+    // would also invalidate the block bounds of ranked OR queries
+    return std::log(1.0 + (std::max(totalDocs - df, 0.0) + 0.5) / (df + 0.5));
+}
+
+double QueryProcessor::bm25(double tf, double docLength, double idf, double avgLength) {
+    // BM25 parameters (Robertson & Zaragoza)
+    const double k1 = 1.2;
+    const double b = 0.75;
+    
+    return idf * tf * (k1 + 1.0) / (tf + k1 * (1.0 - b + b * docLength / avgLength));
+}
+
+double QueryProcessor::termScore(const Posting& posting, double idf, double avgLength) const {
+    return bm25(posting.tf, indexHandler.getDocumentLength(posting.doc), idf, avgLength);
+}
+
+std::vector<QueryResult> QueryProcessor::processQuery(const std::string& query) {
+    // Lists of words (or of OR'ed words) take the planned term-at-a-time paths;
+    // any other expression streams through a tree of posting iterators
+    ParsedQuery parsed;
+    std::optional<QueryNode> root = parseQuery(query, parsed.stopwords);
+    bool flat = !root || flattenQuery(*root, parsed);
+    unverifiedPhrases = root && hasUnverifiedPhrase(*root);
+    std::string key = flat ? cacheKey(parsed) : canonicalize(*root);
+    auto rank = [&]() { return flat ? rankQuery(parsed) : rankExpression(*root); };
+    if (!cache) {
+        return materializeResults(rank());
+    }
+    
+    // A cached ranking is reused until the index changes
+    uint64_t generation = indexHandler.getGeneration();
+    std::vector<ScoredDocument> top;
+    if (!cache->find(key, generation, top)) {
+        top = rank();
+        cache->insert(key, generation, top);
+    }
+    return materializeResults(top);
+}
+
+bool QueryProcessor::hasUnverifiedPhrase(const QueryNode& node) const {
+    if (node.type == QueryNode::Type::Phrase) {
+        PhrasePlan plan = planPhrase(node.phrase);
+        return !plan.empty && !plan.positional && plan.lists.size() > 1;
+    }
+    return std::any_of(node.children.begin(), node.children.end(), [this](const QueryNode& child) {
+        return hasUnverifiedPhrase(child);
+    });
+}
+
+PostingIteratorPtr QueryProcessor::compile(const QueryNode& node) {
+    const double avgLength = indexHandler.getAverageDocumentLength();
+    auto wordIterator = [&](const std::string& term) -> PostingIteratorPtr {
+        const PostingList* list = indexHandler.getWordPostings(term);
+        if (!list) {
+            return nullptr;
+        }
+        double idf = inverseDocumentFrequency(list->documentFrequency());
+        return std::make_unique<ListIterator>(*list, indexHandler, idf, avgLength);
+    };
+    auto entityIterator = [](const PostingList* list) -> PostingIteratorPtr {
+        return list ? std::make_unique<ListIterator>(*list, kEntityBoost) : nullptr;
+    };
+    
+    switch (node.type) {
+        case QueryNode::Type::Word:
+            return wordIterator(node.value);
+        case QueryNode::Type::Organization:
+            return entityIterator(indexHandler.getOrganizationPostings(node.value));
+        case QueryNode::Type::Person:
+            return entityIterator(indexHandler.getPersonPostings(node.value));
+        case QueryNode::Type::Phrase: {
+            PhrasePlan plan = planPhrase(node.phrase);
+            if (plan.empty) {
+                return nullptr;
+            }
             
-            for (const auto& [docID, score] : termResults) {
-                if (scores.find(docID) != scores.end()) {
-                    tempScores[docID] = scores[docID] + score;
+            // The words score as usual; bigram lists only narrow the candidates
+            std::vector<PostingIteratorPtr> units;
+            for (const auto& term : node.phrase.terms) {
+                units.push_back(wordIterator(term));
+            }
+            for (size_t u = 0; u < plan.units.size(); ++u) {
+                if (plan.units[u].find(' ') != std::string::npos) {
+                    units.push_back(std::make_unique<ListIterator>(*plan.lists[u], 0.0));
                 }
             }
-            
-            scores = tempScores;
+            PostingIteratorPtr all = std::make_unique<AndIterator>(std::move(units));
+            if (!plan.positional || plan.lists.size() == 1) {
+                return all;
+            }
+            return std::make_unique<FilterIterator>(std::move(all), [this, plan = std::move(plan)](uint32_t doc) {
+                return matchesPhrase(plan, doc);
+            });
+        }
+        case QueryNode::Type::And: {
+            // Negated operands restrict the others; a missing positive operand
+            // empties the conjunction and a missing negated one excludes nothing
+            std::vector<PostingIteratorPtr> required;
+            std::vector<PostingIteratorPtr> excluded;
+            for (const auto& child : node.children) {
+                if (child.type == QueryNode::Type::Not) {
+                    if (auto iterator = compile(child.children.front())) {
+                        excluded.push_back(std::move(iterator));
+                    }
+                }
+                else if (auto iterator = compile(child)) {
+                    required.push_back(std::move(iterator));
+                }
+                else {
+                    return nullptr;
+                }
+            }
+            if (required.empty()) {
+                return nullptr;
+            }
+            PostingIteratorPtr matches = required.size() == 1
+                ? std::move(required.front()) : std::make_unique<AndIterator>(std::move(required));
+            if (excluded.empty()) {
+                return matches;
+            }
+            PostingIteratorPtr exclusion = excluded.size() == 1
+                ? std::move(excluded.front()) : std::make_unique<OrIterator>(std::move(excluded));
+            return std::make_unique<AndNotIterator>(std::move(matches), std::move(exclusion));
+        }
+        case QueryNode::Type::Or: {
+            std::vector<PostingIteratorPtr> alternatives;
+            for (const auto& child : node.children) {
+                if (auto iterator = compile(child)) {
+                    alternatives.push_back(std::move(iterator));
+                }
+            }
+            if (alternatives.size() <= 1) {
+                return alternatives.empty() ? nullptr : std::move(alternatives.front());
+            }
+            return std::make_unique<OrIterator>(std::move(alternatives));
+        }
+        case QueryNode::Type::Not:
+            // Only a conjunction gives a negation something to restrict
+            return nullptr;
+    }
+    return nullptr;
+}
+
+std::vector<QueryProcessor::ScoredDocument> QueryProcessor::rankExpression(const QueryNode& root) {
+    std::vector<ScoredDocument> top;
+    PostingIteratorPtr matches = compile(root);
+    if (!matches) {
+        return top;
+    }
+    
+    // One pass in document order; only the best kResultLimit are kept
+    bool deletions = indexHandler.getDeletedCount() > 0;
+    for (uint32_t doc = matches->doc(); doc != PostingIterator::kEnd; doc = matches->next()) {
+        if (!deletions || !indexHandler.isDeleted(doc)) {
+            offerResult(top, kResultLimit, matches->score(), doc);
+        }
+    }
+    std::sort_heap(top.begin(), top.end(), rankedBefore);
+    return top;
+}
+
+QueryProcessor::QueryPlan QueryProcessor::planQuery(const ParsedQuery& parsed) const {
+    QueryPlan plan;
+    auto addOperand = [](std::vector<PlanOperand>& operands, const char* kind, const std::string& label,
+                         const PostingList* list) {
+        operands.push_back({kind, label, list, list ? list->documentFrequency() : 0});
+    };
+    
+    for (const auto& term : parsed.terms) {
+        addOperand(plan.conjuncts, "word", term, indexHandler.getWordPostings(term));
+    }
+    for (const auto& org : parsed.orgs) {
+        addOperand(plan.conjuncts, "org", org, indexHandler.getOrganizationPostings(org));
+    }
+    for (const auto& person : parsed.persons) {
+        addOperand(plan.conjuncts, "person", person, indexHandler.getPersonPostings(person));
+    }
+    for (const auto& exclusion : parsed.exclusions) {
+        addOperand(plan.exclusions, "word", exclusion, indexHandler.getWordPostings(exclusion));
+    }
+    
+    // Bigram lists of phrases are conjuncts too; their word lists already are
+    for (const auto& phrase : parsed.phrases) {
+        PhrasePlan phrasePlan = planPhrase(phrase);
+        plan.empty = plan.empty || phrasePlan.empty;
+        for (size_t u = 0; u < phrasePlan.units.size(); ++u) {
+            if (phrasePlan.units[u].find(' ') != std::string::npos) {
+                addOperand(plan.conjuncts, "bigram", phrasePlan.units[u], phrasePlan.lists[u]);
+            }
+        }
+        plan.phrases.push_back(std::move(phrasePlan));
+    }
+    
+    auto byCost = [](const PlanOperand& a, const PlanOperand& b) {
+        return a.documentFrequency < b.documentFrequency;
+    };
+    std::stable_sort(plan.conjuncts.begin(), plan.conjuncts.end(), byCost);
+    std::stable_sort(plan.exclusions.begin(), plan.exclusions.end(), byCost);
+    
+    // Missing lists sort first, so one check covers every conjunct
+    plan.empty = plan.empty || plan.conjuncts.empty() || !plan.conjuncts.front().list;
+    return plan;
+}
+
+std::unordered_map<uint32_t, double> QueryProcessor::evaluateConjunction(const ParsedQuery& parsed,
+                                                                         const QueryPlan& plan) {
+    std::unordered_map<uint32_t, double> scores;
+    if (plan.empty) {
+        return scores;
+    }
+    
+    // Intersect rarest first: the candidates only shrink and longer lists are
+    // galloped through, stopping as soon as nothing is left
+    std::vector<uint32_t>& candidates = candidateScratch;
+    candidates.clear();
+    for (const auto& posting : plan.conjuncts.front().list->postings) {
+        candidates.push_back(posting.doc);
+    }
+    for (size_t i = 1; i < plan.conjuncts.size() && !candidates.empty(); ++i) {
+        intersectPostings(candidates, plan.conjuncts[i].list->postings);
+    }
+    for (size_t i = 0; i < plan.exclusions.size() && !candidates.empty(); ++i) {
+        if (plan.exclusions[i].list) {
+            subtractPostings(candidates, plan.exclusions[i].list->postings);
         }
     }
     
+    // Documents tombstoned by incremental re-indexing keep their postings
+    if (indexHandler.getDeletedCount() > 0) {
+        std::erase_if(candidates, [this](uint32_t doc) { return indexHandler.isDeleted(doc); });
+    }
+    if (candidates.empty()) {
+        return scores;
+    }
+    
+    // Score the survivors term by term in query order, walking each list
+    // forward once; every survivor matches every entity
+    const double avgLength = indexHandler.getAverageDocumentLength();
+    std::vector<double> candidateScores(candidates.size(), 0.0);
+    for (const auto& term : parsed.terms) {
+        const PostingList* termResults = indexHandler.getWordPostings(term);
+        double idf = inverseDocumentFrequency(termResults->documentFrequency());
+        size_t index = 0;
+        for (size_t c = 0; c < candidates.size(); ++c) {
+            index = gallopTo(termResults->postings, index, candidates[c]);
+            candidateScores[c] += termScore(termResults->postings[index], idf, avgLength);
+        }
+    }
+    size_t entities = parsed.orgs.size() + parsed.persons.size();
+    for (size_t e = 0; e < entities; ++e) {
+        for (double& score : candidateScores) {
+            score += kEntityBoost;
+        }
+    }
+    
+    scores.reserve(candidates.size());
+    for (size_t c = 0; c < candidates.size(); ++c) {
+        scores.emplace(candidates[c], candidateScores[c]);
+    }
+    
+    // Positions are decoded only for documents that passed everything else
+    for (const auto& phrasePlan : plan.phrases) {
+        applyPhrase(scores, phrasePlan);
+    }
+    return scores;
+}
+
+std::vector<QueryProcessor::ScoredDocument> QueryProcessor::rankQuery(const ParsedQuery& parsed) {
+    if (!parsed.anyTerm) {
+        return selectTop(evaluateConjunction(parsed, planQuery(parsed)), kResultLimit);
+    }
+    
+    // Ranked OR without phrases only needs the top documents, so most postings
+    // can be skipped
+    std::vector<ScoredDocument> top;
+    if (pruning && parsed.phrases.empty() && rankDisjunction(parsed, kResultLimit, top)) {
+        return top;
+    }
+    
+    // Otherwise score every posting of every term; entities add a boost, and
+    // phrases are still required
+    std::unordered_map<uint32_t, double> scores;
+    const double avgLength = indexHandler.getAverageDocumentLength();
+    for (const auto& term : parsed.terms) {
+        const PostingList* termResults = indexHandler.getWordPostings(term);
+        if (!termResults) continue;
+        double idf = inverseDocumentFrequency(termResults->documentFrequency());
+        for (const auto& posting : termResults->postings) {
+            scores[posting.doc] += termScore(posting, idf, avgLength);
+        }
+    }
+    for (const auto& phrase : parsed.phrases) {
+        applyPhrase(scores, planPhrase(phrase));
+    }
+    
     // Add organization matches
-    for (const auto& org : orgs) {
-        auto orgResults = indexHandler.searchOrganization(org);
-        for (const auto& [docID, score] : orgResults) {
-            scores[docID] = scores.count(docID) ? scores[docID] + score * 1.5 : score * 1.5;
+    for (const auto& org : parsed.orgs) {
+        const PostingList* orgResults = indexHandler.getOrganizationPostings(org);
+        if (!orgResults) continue;
+        for (const auto& posting : orgResults->postings) {
+            scores[posting.doc] += kEntityBoost;
         }
     }
     
     // Add person matches
-    for (const auto& person : persons) {
-        auto personResults = indexHandler.searchPerson(person);
-        for (const auto& [docID, score] : personResults) {
-            scores[docID] = scores.count(docID) ? scores[docID] + score * 1.5 : score * 1.5;
+    for (const auto& person : parsed.persons) {
+        const PostingList* personResults = indexHandler.getPersonPostings(person);
+        if (!personResults) continue;
+        for (const auto& posting : personResults->postings) {
+            scores[posting.doc] += kEntityBoost;
         }
     }
     
-    // Apply exclusions
-    applyExclusions(scores, exclusions);
+    // As in the AND path, exclusions gallop through the sorted candidates
+    std::vector<uint32_t>& candidates = candidateScratch;
+    candidates.clear();
+    candidates.reserve(scores.size());
+    for (const auto& [doc, score] : scores) {
+        candidates.push_back(doc);
+    }
+    std::sort(candidates.begin(), candidates.end());
+    for (const auto& term : parsed.exclusions) {
+        if (const PostingList* list = indexHandler.getWordPostings(term)) {
+            subtractPostings(candidates, list->postings);
+        }
+    }
+    
+    // Documents tombstoned by incremental re-indexing keep their postings
+    if (indexHandler.getDeletedCount() > 0) {
+        std::erase_if(candidates, [this](uint32_t doc) { return indexHandler.isDeleted(doc); });
+    }
     
-    // Rank and return results
-    return rankResults(scores);
+    for (uint32_t doc : candidates) {
+        offerResult(top, kResultLimit, scores.find(doc)->second, doc);
+    }
+    std::sort_heap(top.begin(), top.end(), rankedBefore);
+    return top;
 }
 
-std::vector<QueryResult> QueryProcessor::rankResults(
-    const std::unordered_map<std::string, double>& rawScores, size_t limit) {
+std::string QueryProcessor::explain(const std::string& query) {
+    ParsedQuery parsed;
+    std::optional<QueryNode> root = parseQuery(query, parsed.stopwords);
+    std::ostringstream out;
+    auto listStopwords = [&out, &parsed]() {
+        if (!parsed.stopwords.empty()) {
+            out << "Dropped stopwords:";
+            for (const auto& word : parsed.stopwords) {
+                out << ' ' << word;
+            }
+            out << "\n";
+        }
+    };
     
+    if (root && !flattenQuery(*root, parsed)) {
+        canonicalize(*root);
+        out << "Expression: one pass over the posting lists, doc at a time\n";
+        explainNode(*root, 1, out);
+        listStopwords();
+        return out.str();
+    }
+    QueryPlan plan = planQuery(parsed);
+    
+    auto describe = [&out](size_t step, const PlanOperand& operand) {
+        out << "  " << std::setw(2) << step << ". " << std::left << std::setw(7) << operand.kind
+            << std::setw(34) << ('"' + operand.label + '"') << std::right;
+        if (operand.list) {
+            out << "df " << operand.documentFrequency << "\n";
+        }
+        else {
+            out << "no postings\n";
+        }
+    };
+    
+    if (!parsed.anyTerm) {
+        out << "AND: intersect rarest first\n";
+    }
+    else if (pruning && parsed.phrases.empty()) {
+        out << "OR: rank with Block-Max WAND over\n";
+    }
+    else {
+        out << "OR: score every posting of\n";
+    }
+    for (size_t i = 0; i < plan.conjuncts.size(); ++i) {
+        describe(i + 1, plan.conjuncts[i]);
+    }
+    if (!plan.exclusions.empty()) {
+        out << (parsed.anyTerm ? "Exclude:\n" : "Subtract from the candidates:\n");
+        for (size_t i = 0; i < plan.exclusions.size(); ++i) {
+            describe(i + 1, plan.exclusions[i]);
+        }
+    }
+    for (const auto& phrasePlan : plan.phrases) {
+        out << "Verify phrase:";
+        for (const auto& unit : phrasePlan.units) {
+            out << " [" << unit << "]";
+        }
+        out << (phrasePlan.positional ? "\n" : " (no positions: plain AND)\n");
+    }
+    listStopwords();
+    if (!parsed.anyTerm && plan.empty) {
+        out << "Empty: a required list has no postings, nothing is read\n";
+    }
+    return out.str();
+}
+
+void QueryProcessor::explainNode(const QueryNode& node, size_t depth, std::ostream& out) const {
+    out << std::string(2 * depth, ' ');
+    auto describeList = [&out](const char* kind, const std::string& label, const PostingList* list) {
+        out << std::left << std::setw(7) << kind << std::setw(34) << ('"' + label + '"') << std::right;
+        if (list) {
+            out << "df " << list->documentFrequency() << "\n";
+        }
+        else {
+            out << "no postings\n";
+        }
+    };
+    
+    switch (node.type) {
+        case QueryNode::Type::Word:
+            describeList("word", node.value, indexHandler.getWordPostings(node.value));
+            return;
+        case QueryNode::Type::Organization:
+            describeList("org", node.value, indexHandler.getOrganizationPostings(node.value));
+            return;
+        case QueryNode::Type::Person:
+            describeList("person", node.value, indexHandler.getPersonPostings(node.value));
+            return;
+        case QueryNode::Type::Phrase: {
+            PhrasePlan plan = planPhrase(node.phrase);
+            out << "phrase";
+            for (const auto& unit : plan.units) {
+                out << " [" << unit << "]";
+            }
+            out << (plan.empty ? " (no postings)\n" : plan.positional ? "\n" : " (no positions: plain AND)\n");
+            return;
+        }
+        case QueryNode::Type::And:
+            out << "AND, rarest first, then NOT\n";
+            break;
+        case QueryNode::Type::Or:
+            out << "OR\n";
+            break;
+        case QueryNode::Type::Not:
+            out << "NOT\n";
+            break;
+    }
+    for (const auto& child : node.children) {
+        explainNode(child, depth + 1, out);
+    }
+}
+
+std::vector<QueryResult> QueryProcessor::rankResults(
+    const std::unordered_map<uint32_t, double>& rawScores, size_t limit) {
+    return materializeResults(selectTop(rawScores, limit));
+}
+
+std::vector<QueryProcessor::ScoredDocument> QueryProcessor::selectTop(
+    const std::unordered_map<uint32_t, double>& scores, size_t limit) const {
+    std::vector<ScoredDocument> top;
+    top.reserve(std::min(limit, scores.size()));
+    for (const auto& [doc, score] : scores) {
+        offerResult(top, limit, score, doc);
+    }
+    std::sort_heap(top.begin(), top.end(), rankedBefore);
+    return top;
+}
+
+std::vector<QueryResult> QueryProcessor::materializeResults(const std::vector<ScoredDocument>& top) const {
+    // Metadata is only needed for the documents actually returned
     std::vector<QueryResult> results;
+    results.reserve(top.size());
+    for (const auto& [score, doc] : top) {
+        DocumentView info = indexHandler.getDocumentMetadata(doc);
+        QueryResult result(indexHandler.getDocumentID(doc), score);
+        result.title = info.title;
+        result.date = DocumentStore::formatDate(info.published);
+        result.source = info.source;
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+bool QueryProcessor::rankDisjunction(const ParsedQuery& query, size_t limit, std::vector<ScoredDocument>& top) {
+    const double avgLength = indexHandler.getAverageDocumentLength();
     
-    for (const auto& [docID, score] : rawScores) {
-        auto meta = indexHandler.getDocumentMetadata(docID);
-        rapidjson::Document doc;
-        doc.Parse(meta.c_str());
+    // One cursor per word, then per entity, in query order: full scores are
+    // summed in this order so they equal the exhaustive sums bit for bit
+    std::vector<ScoreCursor> cursors;
+    for (const auto& term : query.terms) {
+        const PostingList* list = indexHandler.getWordPostings(term);
+        if (!list) continue;
+        if (!list->hasBlocks()) {
+            return false;
+        }
+        ScoreCursor cursor{list};
+        cursor.idf = inverseDocumentFrequency(list->documentFrequency());
+        for (const auto& block : list->blocks) {
+            cursor.maxScore = std::max(cursor.maxScore, bm25(block.maxTf, block.minLength, cursor.idf, avgLength));
+        }
+        cursor.maxScore *= kBoundSlack;
+        cursors.push_back(cursor);
+    }
+    auto addEntity = [&cursors](const PostingList* list) {
+        if (list) {
+            ScoreCursor cursor{list};
+            cursor.boost = kEntityBoost;
+            cursor.maxScore = kEntityBoost;
+            cursors.push_back(cursor);
+        }
+    };
+    for (const auto& org : query.orgs) {
+        addEntity(indexHandler.getOrganizationPostings(org));
+    }
+    for (const auto& person : query.persons) {
+        addEntity(indexHandler.getPersonPostings(person));
+    }
+    
+    std::vector<std::pair<const PostingList*, size_t>> excluded;
+    for (const auto& term : query.exclusions) {
+        if (const PostingList* list = indexHandler.getWordPostings(term)) {
+            excluded.emplace_back(list, 0);
+        }
+    }
+    
+    auto docOf = [](const ScoreCursor& cursor) {
+        return cursor.index < cursor.list->postings.size() ? cursor.list->postings[cursor.index].doc : kNoMoreDocuments;
+    };
+    auto moveTo = [](ScoreCursor& cursor, uint64_t doc) {
+        cursor.index = doc > kNoMoreDocuments ? cursor.list->postings.size()
+                                              : gallopTo(cursor.list->postings, cursor.index, static_cast<uint32_t>(doc));
+    };
+    // Move to the block that would hold doc and return the bound of that block,
+    // which also covers the following documents up to blockEnd
+    auto blockBound = [avgLength](ScoreCursor& cursor, uint32_t doc, uint32_t& blockEnd) {
+        const auto& blocks = cursor.list->blocks;
+        if (cursor.boost > 0.0 || blocks.empty()) {
+            return cursor.maxScore;
+        }
+        while (cursor.block + 1 < blocks.size() && blocks[cursor.block].lastDoc < doc) {
+            ++cursor.block;
+        }
+        const PostingBlock& block = blocks[cursor.block];
+        blockEnd = std::min(blockEnd, block.lastDoc);
+        return bm25(block.maxTf, block.minLength, cursor.idf, avgLength) * kBoundSlack;
+    };
+    auto admitted = [&](uint32_t doc) {
+        if (indexHandler.isDeleted(doc)) {
+            return false;
+        }
+        for (auto& [list, index] : excluded) {
+            index = gallopTo(list->postings, index, doc);
+            if (index < list->postings.size() && list->postings[index].doc == doc) {
+                return false;
+            }
+        }
+        return true;
+    };
+    
+    top.clear();
+    std::vector<ScoreCursor*> order;
+    for (auto& cursor : cursors) {
+        order.push_back(&cursor);
+    }
+    
+    while (true) {
+        std::sort(order.begin(), order.end(), [&docOf](const ScoreCursor* a, const ScoreCursor* b) {
+            return docOf(*a) < docOf(*b);
+        });
         
-        QueryResult result(docID, score);
+        // Until the page is full every document enters; then only one that beats
+        // the k-th score (later documents lose ties)
+        const bool filling = top.size() < limit;
+        const double threshold = filling ? 0.0 : top.front().first;
+        auto beats = [filling, threshold](double score) {
+            return filling || score > threshold;
+        };
         
-        if (doc.HasMember("title") && doc["title"].IsString()) {
-            result.title = doc["title"].GetString();
+        // Pivot: the first cursor at which the lists so far could beat the threshold.
+        // Earlier documents only occur in the lists before it, so they cannot.
+        size_t pivot = order.size();
+        double bound = 0.0;
+        for (size_t i = 0; i < order.size() && docOf(*order[i]) != kNoMoreDocuments; ++i) {
+            bound += order[i]->maxScore;
+            if (beats(bound)) {
+                pivot = i;
+                break;
+            }
         }
-        
-        if (doc.HasMember("date") && doc["date"].IsString()) {
-            result.date = doc["date"].GetString();
+        if (pivot == order.size()) {
+            break;
+        }
+        uint32_t pivotDoc = docOf(*order[pivot]);
+        while (pivot + 1 < order.size() && docOf(*order[pivot + 1]) == pivotDoc) {
+            ++pivot;
         }
         
-        if (doc.HasMember("source") && doc["source"].IsString()) {
-            result.source = doc["source"].GetString();
+        // The blocks that hold pivotDoc bound it and the documents after it up to
+        // the first block end or the next list's document, whichever comes first
+        uint32_t blockEnd = kNoMoreDocuments;
+        double blockSum = 0.0;
+        for (size_t i = 0; i <= pivot; ++i) {
+            blockSum += blockBound(*order[i], pivotDoc, blockEnd);
         }
         
-        results.push_back(result);
-    }
-    
-    // Sort by score (descending order)
-    std::sort(results.begin(), results.end(), 
-             [](const QueryResult& a, const QueryResult& b) {
-                 return a.score > b.score;
-             });
-    
-    // Limit results
-    if (results.size() > limit) {
-        results.resize(limit);
+        if (beats(blockSum)) {
+            if (docOf(*order[0]) == pivotDoc) {
+                double score = 0.0;
+                for (auto& cursor : cursors) {
+                    if (docOf(cursor) == pivotDoc) {
+                        score += cursor.boost > 0.0 ? cursor.boost
+                                                    : termScore(cursor.list->postings[cursor.index], cursor.idf, avgLength);
+                    }
+                }
+                if (beats(score) && admitted(pivotDoc)) {
+                    offerResult(top, limit, score, pivotDoc);
+                }
+                for (size_t i = 0; i <= pivot; ++i) {
+                    ++order[i]->index;
+                }
+            }
+            else {
+                for (size_t i = 0; i < pivot && docOf(*order[i]) < pivotDoc; ++i) {
+                    moveTo(*order[i], pivotDoc);
+                }
+            }
+        }
+        else {
+            uint64_t next = static_cast<uint64_t>(blockEnd) + 1;
+            if (pivot + 1 < order.size()) {
+                next = std::min<uint64_t>(next, docOf(*order[pivot + 1]));
+            }
+            for (size_t i = 0; i <= pivot; ++i) {
+                moveTo(*order[i], next);
+            }
+        }
     }
     
-    return results;
+    std::sort_heap(top.begin(), top.end(), rankedBefore);
+    return true;
 }
 
 std::string QueryProcessor::getFullArticle(const std::string& docID) const {
@@ -0,0 +1,87 @@
+/**
+ * @file SimHash.cpp
+ * @author <YourName>
+ * @brief Implementation of SimHash fingerprints and the banded near-duplicate index
+ */
+
+#include "../include/SimHash.h"
+
+uint64_t SimHash::hash(std::string_view text) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (unsigned char c : text) {
+        h ^= c;
+        h *= 0x100000001B3ULL;
+    }
+    return mix(h);
+}
+
+void SimHash::add(uint64_t feature) {
+    for (int bit = 0; bit < 64; ++bit) {
+        votes[bit] += (feature >> bit) & 1 ? 1 : -1;
+    }
+    features++;
+}
+
+uint64_t SimHash::fingerprint() const {
+    if (features == 0) {
+        return 0;
+    }
+    
+    uint64_t result = 0;
+    for (int bit = 0; bit < 64; ++bit) {
+        if (votes[bit] > 0) {
+            result |= 1ULL << bit;
+        }
+    }
+    return result;
+}
+
+void SimHashIndex::insert(uint32_t doc, uint64_t fingerprint) {
+    if (fingerprint == 0) {
+        return;
+    }
+    if (doc >= documentFingerprints.size()) {
+        documentFingerprints.resize(doc + 1, 0);
+    }
+    documentFingerprints[doc] = fingerprint;
+    
+    if (buckets.empty()) {
+        buckets.resize(static_cast<size_t>(kBands) << kBandBits);
+    }
+    for (int b = 0; b < kBands; ++b) {
+        buckets[bucket(fingerprint, b)].push_back(doc);
+    }
+}
+
+uint32_t SimHashIndex::find(uint64_t fingerprint) const {
+    if (fingerprint == 0 || buckets.empty()) {
+        return kNotFound;
+    }
+    
+    uint32_t best = kNotFound;
+    for (int b = 0; b < kBands; ++b) {
+        // Buckets list ordinals in ascending order, so the first hit is the earliest in the band
+        for (uint32_t doc : buckets[bucket(fingerprint, b)]) {
+            if (doc >= best) {
+                break;
+            }
+            uint64_t candidate = documentFingerprints[doc];
+            if (candidate != 0 && SimHash::distance(candidate, fingerprint) <= kMaxDistance) {
+                best = doc;
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+void SimHashIndex::erase(uint32_t doc) {
+    if (doc < documentFingerprints.size()) {
+        documentFingerprints[doc] = 0;
+    }
+}
+
+void SimHashIndex::clear() {
+    documentFingerprints.clear();
+    buckets.clear();
+}
@@ -0,0 +1,111 @@
+/**
+ * @file StemCache.cpp
+ * @author <YourName>
+ * @brief Implementation of the stem cache
+ */
+
+#include "../include/StemCache.h"
+#include "../thirdparty/porter2_stemmer/thirdparty/porter2_stemmer/porter2_stemmer.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+uint64_t elapsedNanos(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+} // namespace
+
+StemCache::StemCache(size_t capacity)
+    : generationCapacity(std::max<size_t>(1, capacity / kShardCount / 2)) {
+}
+
+StemCache& StemCache::shared() {
+    static StemCache cache;
+    return cache;
+}
+
+void StemCache::stem(std::string& word) {
+    // Each thread samples its own calls, so deciding costs no shared access and
+    // the clock is read only for sampled calls
+    static thread_local uint64_t calls = 0;
+    const bool sampled = (calls++ & kSampleMask) == 0;
+    std::chrono::steady_clock::time_point start;
+    if (sampled) {
+        start = std::chrono::steady_clock::now();
+    }
+
+    Shard& shard = shards[(StringHash{}(word) >> 7) % kShardCount];
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.current.find(word);
+        bool found = it != shard.current.end();
+        if (found) {
+            word.assign(it->second);
+        }
+        else if ((it = shard.previous.find(word)) != shard.previous.end()) {
+            // Promote so words still in use survive the next generation swap
+            word.assign(it->second);
+            auto node = shard.previous.extract(it);
+            rotateIfFull(shard);
+            shard.current.insert(std::move(node));
+            found = true;
+        }
+
+        if (found) {
+            shard.hits++;
+            if (sampled) {
+                shard.sampledHits++;
+                shard.sampledHitNanos += elapsedNanos(start);
+            }
+            return;
+        }
+    }
+
+    // Stem outside the lock; a concurrent miss on the same word just inserts twice
+    std::string surface = word;
+    Porter2Stemmer::stem(word);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    rotateIfFull(shard);
+    shard.current.emplace(std::move(surface), word);
+    shard.misses++;
+    if (sampled) {
+        shard.sampledMisses++;
+        shard.sampledMissNanos += elapsedNanos(start);
+    }
+}
+
+void StemCache::rotateIfFull(Shard& shard) const {
+    if (shard.current.size() >= generationCapacity) {
+        shard.previous = std::move(shard.current);
+        shard.current.clear();
+    }
+}
+
+StemCache::Stats StemCache::getStats() const {
+    Stats stats;
+    uint64_t sampledHits = 0, sampledHitNanos = 0, sampledMisses = 0, sampledMissNanos = 0;
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.hits += shard.hits;
+        stats.misses += shard.misses;
+        stats.entries += shard.current.size() + shard.previous.size();
+        sampledHits += shard.sampledHits;
+        sampledHitNanos += shard.sampledHitNanos;
+        sampledMisses += shard.sampledMisses;
+        sampledMissNanos += shard.sampledMissNanos;
+    }
+
+    if (sampledHits) {
+        stats.avgHitNanos = static_cast<double>(sampledHitNanos) / sampledHits;
+    }
+    if (sampledMisses) {
+        stats.avgMissNanos = static_cast<double>(sampledMissNanos) / sampledMisses;
+    }
+    return stats;
+}
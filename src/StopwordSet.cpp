@@ -0,0 +1,31 @@
+/**
+ * @file StopwordSet.cpp
+ * @author <YourName>
+ * @brief Implementation of the runtime stopword override
+ */
+
+#include "../include/StopwordSet.h"
+#include <fstream>
+#include <iostream>
+
+StopwordSet::StopwordSet(const std::string& filename) {
+    if (!filename.empty() && !loadFile(filename)) {
+        std::cerr << "Warning: Could not open stopwords file: " << filename
+                  << " (using built-in list)" << std::endl;
+    }
+}
+
+bool StopwordSet::loadFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file) {
+        return false;
+    }
+
+    overrideWords.clear();
+    std::string word;
+    while (file >> word) {
+        overrideWords.insert(word);
+    }
+    useOverride = true;
+    return true;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file TermTrie.cpp
+ * @author <YourName>
+ * @brief Implementation of the term trie
+ */
+
+#include "../include/TermTrie.h"
+
+void TermTrie::build(const std::vector<std::string_view>& words) {
+    clear();
+    subtreeEnd.push_back(0);
+    labels.push_back(0);
+    terminal.push_back(0);
+    
+    // path[d] is the node of the previous word's prefix of length d; a word
+    // closes the subtrees of the previous word below their common prefix
+    std::vector<uint32_t> path = {0};
+    std::string_view previous;
+    for (std::string_view word : words) {
+        size_t common = 0;
+        while (common < previous.size() && common < word.size() && previous[common] == word[common]) {
+            ++common;
+        }
+        while (path.size() > common + 1) {
+            subtreeEnd[path.back()] = static_cast<uint32_t>(labels.size());
+            path.pop_back();
+        }
+        for (size_t i = common; i < word.size(); ++i) {
+            path.push_back(static_cast<uint32_t>(labels.size()));
+            subtreeEnd.push_back(0);
+            labels.push_back(static_cast<uint8_t>(word[i]));
+            terminal.push_back(0);
+        }
+        terminal[path.back()] = 1;
+        previous = word;
+    }
+    for (uint32_t node : path) {
+        subtreeEnd[node] = static_cast<uint32_t>(labels.size());
+    }
+}
+
+std::vector<std::pair<std::string, uint32_t>> TermTrie::match(LevenshteinAutomaton& automaton) const {
+    std::vector<std::pair<std::string, uint32_t>> matches;
+    if (labels.empty()) {
+        return matches;
+    }
+    
+    std::string prefix;
+    auto walk = [&](auto& self, uint32_t node, uint32_t state) -> void {
+        for (uint32_t child = node + 1; child < subtreeEnd[node]; child = subtreeEnd[child]) {
+            uint32_t next = automaton.step(state, labels[child]);
+            if (!automaton.canMatch(next)) {
+                continue;
+            }
+            prefix.push_back(static_cast<char>(labels[child]));
+            if (terminal[child] && automaton.distance(next) <= automaton.getMaxEdits()) {
+                matches.emplace_back(prefix, automaton.distance(next));
+            }
+            self(self, child, next);
+            prefix.pop_back();
+        }
+    };
+    walk(walk, 0, automaton.start());
+    return matches;
+}
+
+void TermTrie::clear() {
+    subtreeEnd.clear();
+    labels.clear();
+    terminal.clear();
+}
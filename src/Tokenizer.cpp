@@ -0,0 +1,504 @@
+/**
+ * @file Tokenizer.cpp
+ * @author <YourName>
+ * @brief Implementation of the SIMD tokenizer
+ */
+
+#include "../include/Tokenizer.h"
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define TOKENIZER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(TOKENIZER_SSE2) && defined(__GNUC__)
+#define TOKENIZER_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Whitespace, punctuation and non-ASCII bitmasks for one block (bit i = byte i)
+ */
+struct BlockMasks {
+    uint32_t space;
+    uint32_t punct;
+    uint32_t nonAscii;
+};
+
+/**
+ * @brief Classifies a block of input and writes its lowercased bytes to out
+ */
+using ClassifyFn = BlockMasks (*)(const char* in, char* out);
+
+inline bool isSpaceByte(unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline bool isPunctByte(unsigned char c) {
+    return (c >= '!' && c <= '/') || (c >= ':' && c <= '@') ||
+           (c >= '[' && c <= '`') || (c >= '{' && c <= '~');
+}
+
+inline char toLowerByte(unsigned char c) {
+    return static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+}
+
+/**
+ * @brief Decode one UTF-8 sequence starting with a non-ASCII byte
+ * @param text Input
+ * @param pos Offset of the lead byte
+ * @param codePoint Receives the decoded code point
+ * @return Sequence length, or 0 if the bytes at pos are not well-formed UTF-8
+ *         (stray continuation byte, overlong form, surrogate, above U+10FFFF
+ *         or truncated sequence)
+ */
+size_t decodeUTF8(std::string_view text, size_t pos, uint32_t& codePoint) {
+    auto byte = [&](size_t i) { return static_cast<unsigned char>(text[pos + i]); };
+    unsigned char lead = byte(0);
+    size_t length;
+    unsigned char low = 0x80, high = 0xBF;   // allowed range of the second byte
+
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+        codePoint = lead & 0x1F;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        codePoint = lead & 0x0F;
+        low = lead == 0xE0 ? 0xA0 : 0x80;
+        high = lead == 0xED ? 0x9F : 0xBF;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        codePoint = lead & 0x07;
+        low = lead == 0xF0 ? 0x90 : 0x80;
+        high = lead == 0xF4 ? 0x8F : 0xBF;
+    }
+    else {
+        return 0;
+    }
+
+    if (pos + length > text.size() || byte(1) < low || byte(1) > high) {
+        return 0;
+    }
+    for (size_t i = 1; i < length; ++i) {
+        if ((byte(i) & 0xC0) != 0x80) {
+            return 0;
+        }
+        codePoint = (codePoint << 6) | (byte(i) & 0x3F);
+    }
+    return length;
+}
+
+enum class CharClass { Space, Ignored, Kept };
+
+/**
+ * @brief How the tokenizer treats a non-ASCII code point
+ *
+ * Unicode spaces separate tokens like ASCII whitespace. Punctuation, currency
+ * signs and other symbols of the Latin-1, General Punctuation and Currency
+ * blocks are dropped like ASCII punctuation ("company\u2019s" and "company's"
+ * both give "companys"), as are zero-width format characters. Everything else
+ * is part of a word.
+ */
+CharClass classifyCodePoint(uint32_t c) {
+    if (c == 0xA0 || c == 0x1680 || (c >= 0x2000 && c <= 0x200A) || c == 0x2028 || c == 0x2029 ||
+        c == 0x202F || c == 0x205F || c == 0x3000) {
+        return CharClass::Space;
+    }
+    if (c <= 0xFF) {
+        bool symbol = (c >= 0xA1 && c <= 0xBF && c != 0xAA && c != 0xB2 && c != 0xB3 && c != 0xB5 &&
+                       c != 0xB9 && c != 0xBA && (c < 0xBC || c > 0xBE)) ||
+                      c == 0xD7 || c == 0xF7;
+        return symbol ? CharClass::Ignored : CharClass::Kept;
+    }
+    if ((c >= 0x200B && c <= 0x200F) || (c >= 0x2010 && c <= 0x2027) || (c >= 0x202A && c <= 0x202E) ||
+        (c >= 0x2030 && c <= 0x205E) || (c >= 0x2060 && c <= 0x2064) || (c >= 0x20A0 && c <= 0x20CF) ||
+        (c >= 0x3001 && c <= 0x3003) || c == 0xFEFF) {
+        return CharClass::Ignored;
+    }
+    return CharClass::Kept;
+}
+
+/**
+ * @brief Unicode simple case folding for the cased scripts of the news feeds
+ *
+ * Covers Latin (Latin-1, Extended-A and Extended Additional), Greek, Cyrillic,
+ * Armenian and fullwidth Latin, following CaseFolding.txt status C and S; other
+ * code points are returned unchanged. No mapping lengthens the UTF-8 encoding,
+ * so the tokenizer output still never exceeds its input.
+ */
+uint32_t foldCase(uint32_t c) {
+    // Blocks where upper and lower case alternate; upperParity is the parity of the capitals
+    auto alternating = [](uint32_t c, uint32_t upperParity) { return (c & 1) == upperParity ? c + 1 : c; };
+
+    if (c <= 0xFF) {
+        if (c >= 0xC0 && c <= 0xDE && c != 0xD7) {
+            return c + 0x20;
+        }
+        return c == 0xB5 ? 0x3BC : c;   // micro sign -> Greek mu
+    }
+    if (c <= 0x17F) {
+        if (c == 0x130 || c == 0x131 || c == 0x138 || c == 0x149) {
+            return c;                   // dotted/dotless i and letters without a case pair
+        }
+        if (c == 0x178) {
+            return 0xFF;
+        }
+        if (c == 0x17F) {
+            return 's';
+        }
+        bool oddCapitals = (c >= 0x139 && c <= 0x148) || (c >= 0x179 && c <= 0x17E);
+        return alternating(c, oddCapitals ? 1 : 0);
+    }
+    if (c >= 0x386 && c <= 0x3AB) {
+        if (c == 0x386) {
+            return 0x3AC;
+        }
+        if (c >= 0x388 && c <= 0x38A) {
+            return c + 0x25;
+        }
+        if (c == 0x38C) {
+            return 0x3CC;
+        }
+        if (c == 0x38E || c == 0x38F) {
+            return c + 0x3F;
+        }
+        return c >= 0x391 && c != 0x3A2 ? c + 0x20 : c;
+    }
+    if (c == 0x3C2) {
+        return 0x3C3;                   // final sigma
+    }
+    if (c >= 0x400 && c <= 0x52F) {
+        if (c <= 0x40F) {
+            return c + 0x50;
+        }
+        if (c <= 0x42F) {
+            return c + 0x20;
+        }
+        if ((c >= 0x460 && c <= 0x481) || (c >= 0x48A && c <= 0x4BF) || c >= 0x4D0) {
+            return alternating(c, 0);
+        }
+        if (c == 0x4C0) {
+            return 0x4CF;
+        }
+        if (c >= 0x4C1 && c <= 0x4CE) {
+            return alternating(c, 1);
+        }
+        return c;
+    }
+    if (c >= 0x531 && c <= 0x556) {
+        return c + 0x30;
+    }
+    if (c >= 0x1E00 && c <= 0x1EFF) {
+        if (c == 0x1E9E) {
+            return 0xDF;                // capital sharp s
+        }
+        return c <= 0x1E95 || c >= 0x1EA0 ? alternating(c, 0) : c;
+    }
+    if (c == 0x212A) {
+        return 'k';                     // Kelvin sign
+    }
+    if (c == 0x212B) {
+        return 0xE5;                    // Angstrom sign
+    }
+    if (c >= 0xFF21 && c <= 0xFF3A) {
+        return c + 0x20;
+    }
+    return c;
+}
+
+#ifdef TOKENIZER_SSE2
+// Bytes in [lo, hi]; the signed compares are safe because every range is ASCII
+inline __m128i inRange(__m128i v, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                         _mm_cmplt_epi8(v, _mm_set1_epi8(static_cast<char>(hi + 1))));
+}
+
+BlockMasks classifySSE2(const char* in, char* out) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+
+    __m128i space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), inRange(v, '\t', '\r'));
+    __m128i upper = inRange(v, 'A', 'Z');
+    __m128i alnum = _mm_or_si128(_mm_or_si128(upper, inRange(v, 'a', 'z')), inRange(v, '0', '9'));
+    __m128i punct = _mm_andnot_si128(alnum, inRange(v, '!', '~'));
+
+    __m128i lower = _mm_add_epi8(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), lower);
+
+    return {static_cast<uint32_t>(_mm_movemask_epi8(space)),
+            static_cast<uint32_t>(_mm_movemask_epi8(punct)),
+            static_cast<uint32_t>(_mm_movemask_epi8(v))};
+}
+#endif
+
+#ifdef TOKENIZER_AVX2
+__attribute__((target("avx2")))
+inline __m256i inRange256(__m256i v, char lo, char hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), v));
+}
+
+__attribute__((target("avx2")))
+BlockMasks classifyAVX2(const char* in, char* out) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+
+    __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                    inRange256(v, '\t', '\r'));
+    __m256i upper = inRange256(v, 'A', 'Z');
+    __m256i alnum = _mm256_or_si256(_mm256_or_si256(upper, inRange256(v, 'a', 'z')),
+                                    inRange256(v, '0', '9'));
+    __m256i punct = _mm256_andnot_si256(alnum, inRange256(v, '!', '~'));
+
+    __m256i lower = _mm256_add_epi8(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), lower);
+
+    return {static_cast<uint32_t>(_mm256_movemask_epi8(space)),
+            static_cast<uint32_t>(_mm256_movemask_epi8(punct)),
+            static_cast<uint32_t>(_mm256_movemask_epi8(v))};
+}
+#endif
+
+/**
+ * @brief Widest block classifier the CPU supports, or nullptr for scalar only
+ */
+void selectClassifier(ClassifyFn& classify, size_t& width) {
+#ifdef TOKENIZER_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        classify = classifyAVX2;
+        width = 32;
+        return;
+    }
+#endif
+#ifdef TOKENIZER_SSE2
+    classify = classifySSE2;
+    width = 16;
+#else
+    classify = nullptr;
+    width = 0;
+#endif
+}
+
+/**
+ * @brief Appends bytes to the current token and closes tokens at whitespace
+ */
+class TokenWriter {
+public:
+    TokenWriter(char* out, std::vector<std::string_view>& tokens)
+        : out(out), tokenStart(out), tokens(tokens) {}
+
+    // Bytes of a whitespace-free run; set bits of punct mark bytes to drop
+    void appendRun(const char* bytes, size_t length, uint32_t punct) {
+        inToken = true;
+        if (punct == 0) {
+            std::memcpy(out, bytes, length);
+            out += length;
+            return;
+        }
+        for (size_t i = 0; i < length; ++i) {
+            if (!(punct & (1u << i))) {
+                *out++ = bytes[i];
+            }
+        }
+    }
+
+    void appendByte(unsigned char c) {
+        inToken = true;
+        if (!isPunctByte(c)) {
+            *out++ = toLowerByte(c);
+        }
+    }
+
+    void appendCodePoint(uint32_t c) {
+        inToken = true;
+        if (c < 0x800) {
+            *out++ = static_cast<char>(0xC0 | (c >> 6));
+        }
+        else if (c < 0x10000) {
+            *out++ = static_cast<char>(0xE0 | (c >> 12));
+            *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        }
+        else {
+            *out++ = static_cast<char>(0xF0 | (c >> 18));
+            *out++ = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        }
+        *out++ = static_cast<char>(0x80 | (c & 0x3F));
+    }
+
+    void endToken() {
+        if (inToken && out > tokenStart) {
+            tokens.emplace_back(tokenStart, static_cast<size_t>(out - tokenStart));
+        }
+        tokenStart = out;
+        inToken = false;
+    }
+
+private:
+    char* out;
+    char* tokenStart;
+    bool inToken = false;
+    std::vector<std::string_view>& tokens;
+};
+
+/**
+ * @brief Tokenize the character at pos one code point at a time
+ * @return Offset of the next character
+ */
+size_t consumeCharacter(std::string_view text, size_t pos, TokenWriter& writer) {
+    unsigned char c = static_cast<unsigned char>(text[pos]);
+    if (c < 0x80) {
+        if (isSpaceByte(c)) {
+            writer.endToken();
+        }
+        else {
+            writer.appendByte(c);
+        }
+        return pos + 1;
+    }
+
+    uint32_t codePoint;
+    size_t length = decodeUTF8(text, pos, codePoint);
+    if (length == 0) {
+        return pos + 1;                 // malformed byte: dropped, the token goes on
+    }
+
+    switch (classifyCodePoint(codePoint)) {
+    case CharClass::Space:
+        writer.endToken();
+        break;
+    case CharClass::Ignored:
+        break;
+    case CharClass::Kept: {
+        uint32_t folded = foldCase(codePoint);
+        if (folded < 0x80) {
+            writer.appendByte(static_cast<unsigned char>(folded));
+        }
+        else {
+            writer.appendCodePoint(folded);
+        }
+        break;
+    }
+    }
+    return pos + length;
+}
+
+} // namespace
+
+const std::vector<std::string_view>& Tokenizer::tokenize(std::string_view text) {
+    static ClassifyFn classify = nullptr;
+    static size_t width = 0;
+    static const bool selected = (selectClassifier(classify, width), true);
+    (void)selected;
+
+    tokens.clear();
+
+    // Output never exceeds input, so views into scratch stay valid while writing
+    if (scratch.size() < text.size() + 32) {
+        scratch.resize(text.size() + 32);
+    }
+
+    TokenWriter writer(scratch.data(), tokens);
+    const char* in = text.data();
+    size_t pos = 0;
+
+    if (classify) {
+        char lower[32];
+
+        while (pos + width <= text.size()) {
+            BlockMasks masks = classify(in + pos, lower);
+
+            // A block with a non-ASCII byte is validated, decoded and case-folded
+            // character by character; the last sequence may run past the block
+            if (masks.nonAscii) {
+                size_t blockEnd = pos + width;
+                while (pos < blockEnd) {
+                    pos = consumeCharacter(text, pos, writer);
+                }
+                continue;
+            }
+
+            // Walk the whitespace-separated runs of the block
+            size_t i = 0;
+            while (i < width) {
+                uint32_t spacesAhead = i < 32 ? masks.space & (~0u << i) : 0;
+                size_t runEnd = spacesAhead ? static_cast<size_t>(std::countr_zero(spacesAhead)) : width;
+
+                if (runEnd > i) {
+                    uint64_t runMask = (uint64_t{1} << (runEnd - i)) - 1;
+                    writer.appendRun(lower + i, runEnd - i,
+                                     static_cast<uint32_t>((masks.punct >> i) & runMask));
+                }
+                if (runEnd < width) {
+                    writer.endToken();
+                }
+                i = runEnd + 1;
+            }
+            pos += width;
+        }
+    }
+
+    // Scalar tail (or whole input without SIMD)
+    while (pos < text.size()) {
+        pos = consumeCharacter(text, pos, writer);
+    }
+    writer.endToken();
+
+    return tokens;
+}
+
+std::string Tokenizer::normalize(std::string_view word) {
+    std::string result;
+    for (const auto& token : tokenize(word)) {
+        result.append(token);
+    }
+    return result;
+}
+
+std::string Tokenizer::foldCase(std::string_view text) {
+    std::string result;
+    result.reserve(text.size());
+    for (size_t pos = 0; pos < text.size();) {
+        unsigned char c = static_cast<unsigned char>(text[pos]);
+        if (c < 0x80) {
+            result.push_back(toLowerByte(c));
+            ++pos;
+            continue;
+        }
+        uint32_t codePoint;
+        size_t length = decodeUTF8(text, pos, codePoint);
+        if (length == 0 || classifyCodePoint(codePoint) != CharClass::Kept) {
+            length = length == 0 ? 1 : length;   // copied unchanged
+            result.append(text.substr(pos, length));
+            pos += length;
+            continue;
+        }
+
+        uint32_t folded = ::foldCase(codePoint);
+        if (folded < 0x80) {
+            result.push_back(static_cast<char>(folded));
+        }
+        else if (folded < 0x800) {
+            result.push_back(static_cast<char>(0xC0 | (folded >> 6)));
+            result.push_back(static_cast<char>(0x80 | (folded & 0x3F)));
+        }
+        else if (folded < 0x10000) {
+            result.push_back(static_cast<char>(0xE0 | (folded >> 12)));
+            result.push_back(static_cast<char>(0x80 | ((folded >> 6) & 0x3F)));
+            result.push_back(static_cast<char>(0x80 | (folded & 0x3F)));
+        }
+        else {
+            result.push_back(static_cast<char>(0xF0 | (folded >> 18)));
+            result.push_back(static_cast<char>(0x80 | ((folded >> 12) & 0x3F)));
+            result.push_back(static_cast<char>(0x80 | ((folded >> 6) & 0x3F)));
+            result.push_back(static_cast<char>(0x80 | (folded & 0x3F)));
+        }
+        pos += length;
+    }
+    return result;
+}
@@ -5,16 +5,26 @@
  */
 
 #include "../include/UserInterface.h"
+#include "../include/StemCache.h"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
 #include <vector>
 #include <algorithm>
 #include <filesystem>
+#include <iterator>
 
-UserInterface::UserInterface(const std::string& stopwordsFile)
-    : documentParser(indexHandler, stopwordsFile),
-      queryProcessor(indexHandler) {
+UserInterface::UserInterface(const std::string& stopwordsFile, const std::string& aliasesFile,
+                             bool storePositions, size_t memoryBudget, bool detectDuplicates)
+    : stopwords(stopwordsFile),
+      documentParser(indexHandler, stopwords),
+      queryProcessor(indexHandler, stopwords),
+      memoryBudget(memoryBudget) {
+    indexHandler.setStorePositions(storePositions);
+    indexHandler.setDetectDuplicates(detectDuplicates);
+    if (!aliasesFile.empty() && !indexHandler.loadAliases(aliasesFile)) {
+        std::cerr << "Warning: Could not open aliases file: " << aliasesFile << std::endl;
+    }
 }
 
 int UserInterface::run(int argc, char* argv[]) {
@@ -53,18 +63,35 @@ int UserInterface::run(int argc, char* argv[]) {
 
 void UserInterface::displayHelp() const {
     std::cout << "Financial News Search Engine" << std::endl;
-    std::cout << "Usage: supersearch [command] [options]" << std::endl;
+    std::cout << "Usage: supersearch [--stopwords <file>] [--aliases <file>] [--positions]" << std::endl;
+    std::cout << "                   [--memory-budget <MB>] [--dedup] [command] [options]" << std::endl;
     std::cout << std::endl;
     std::cout << "Commands:" << std::endl;
-    std::cout << "  index <path> [output]  - Index JSON documents in directory" << std::endl;
+    std::cout << "  index <path> [output]  - Index a directory of JSON files, a .json," << std::endl;
+    std::cout << "        [--rebuild]        .jsonl or uncompressed .tar file; re-indexing a" << std::endl;
+    std::cout << "                           directory parses only new and changed files" << std::endl;
+    std::cout << "                           unless --rebuild is given" << std::endl;
     std::cout << "  query <search terms>   - Search the index" << std::endl;
+    std::cout << "        [--explain]        (first) also print the evaluation plan" << std::endl;
     std::cout << "  ui                     - Start interactive UI" << std::endl;
     std::cout << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --stopwords <file>     - Use stopwords from file instead of the built-in list" << std::endl;
+    std::cout << "  --aliases <file>       - Entity aliases, one \"alias<TAB>canonical\" per line" << std::endl;
+    std::cout << "  --positions            - Record word positions when indexing (for phrases)" << std::endl;
+    std::cout << "  --memory-budget <MB>   - Spill word postings to temporary runs beyond this" << std::endl;
+    std::cout << "                           size while indexing, merging them when saving" << std::endl;
+    std::cout << "  --dedup                - Collapse near-duplicate articles (SimHash) when indexing" << std::endl;
+    std::cout << std::endl;
     std::cout << "Query syntax:" << std::endl;
     std::cout << "  word1 word2            - Search for documents containing all terms" << std::endl;
-    std::cout << "  ORG:Google            - Search for organization" << std::endl;
-    std::cout << "  PERSON:Musk           - Search for person" << std::endl;
+    std::cout << "  ORG:Google            - Search for organization (case-insensitive)" << std::endl;
+    std::cout << "  PERSON:elon_musk      - Search for person (_ separates words)" << std::endl;
     std::cout << "  -excludeword          - Exclude documents with this term" << std::endl;
+    std::cout << "  a OR b, NOT a, ( )    - Boolean operators (upper case) and grouping" << std::endl;
+    std::cout << "  \"interest rates\"      - Exact phrase (index built with --positions)" << std::endl;
+    std::cout << "  \"rates inflation\"~3   - Terms in order with up to 3 words between" << std::endl;
+    std::cout << "  nvidai~1, ecomony~2    - Words within 1 or 2 edits (misspellings)" << std::endl;
 }
 
 void UserInterface::handleIndexCommand(const std::vector<std::string>& args) {
@@ -73,22 +100,63 @@ void UserInterface::handleIndexCommand(const std::vector<std::string>& args) {
         return;
     }
     
-    std::string path = args[0];
-    std::string outputBase = args.size() > 1 ? args[1] : "financial_index";
+    std::vector<std::string> positional;
+    bool rebuild = false;
+    for (const auto& arg : args) {
+        if (arg == "--rebuild") {
+            rebuild = true;
+        }
+        else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.empty()) {
+        std::cerr << "Error: No path specified for indexing" << std::endl;
+        return;
+    }
     
-    std::cout << "Indexing documents in " << path << "..." << std::endl;
+    std::string path = positional[0];
+    std::string outputBase = positional.size() > 1 ? positional[1] : "financial_index";
+    std::string manifestFile = outputBase + ".manifest";
+    bool directory = std::filesystem::is_directory(path);
     
-    if (std::filesystem::is_directory(path)) {
-        documentParser.parseDirectory(path);
+    // A directory indexed before with the same options is updated in place:
+    // the saved index is loaded and only new and changed files are parsed
+    Manifest manifest;
+    bool positions = indexHandler.storesPositions();
+    bool dedup = indexHandler.detectsDuplicates();
+    if (directory && !rebuild && std::filesystem::exists(outputBase + ".meta") &&
+        manifest.load(manifestFile) && manifest.matches(path, positions, dedup)) {
+        std::cout << "Updating the index of " << path << "..." << std::endl;
+        indexHandler.loadIndices(outputBase);
     }
     else {
-        documentParser.parseJSON(path);
+        std::cout << "Indexing documents in " << path << "..." << std::endl;
+        manifest.reset(path, positions, dedup);
     }
     
+    // The manifest is written only after the index it describes
+    std::filesystem::remove(manifestFile);
+    
+    // Only this batch path spills: it saves once and exits, which is what
+    // merging the runs into the saved index requires
+    indexHandler.setMemoryBudget(memoryBudget);
+    documentParser.parsePath(path, directory ? &manifest : nullptr);
+    
     std::cout << "Saving index to " << outputBase << "..." << std::endl;
     indexHandler.saveIndices(outputBase);
+    if (directory) {
+        manifest.save(manifestFile);
+    }
     
     std::cout << "Indexed " << indexHandler.getTotalDocuments() << " documents." << std::endl;
+    
+    auto stemStats = StemCache::shared().getStats();
+    std::cout << "Stem cache: " << std::fixed << std::setprecision(1) 
+              << stemStats.hitRate() * 100 << "% hit rate over " 
+              << (stemStats.hits + stemStats.misses) << " lookups, " 
+              << stemStats.entries << " entries, avg hit " << stemStats.avgHitNanos 
+              << " ns, avg miss " << stemStats.avgMissNanos << " ns" << std::endl;
 }
 
 void UserInterface::handleQueryCommand(const std::vector<std::string>& args) {
@@ -111,13 +179,26 @@ void UserInterface::handleQueryCommand(const std::vector<std::string>& args) {
     }
     
     // Combine all arguments into a query string
+    bool explain = args.front() == "--explain";
     std::ostringstream query;
-    std::copy(args.begin(), args.end(), std::ostream_iterator<std::string>(query, " "));
+    std::copy(args.begin() + (explain ? 1 : 0), args.end(), std::ostream_iterator<std::string>(query, " "));
     
     std::cout << "Searching for: " << query.str() << std::endl;
+    if (explain) {
+        std::cout << queryProcessor.explain(query.str());
+    }
     
-    auto results = queryProcessor.processQuery(query.str());
+    runQuery(query.str());
+}
+
+std::vector<QueryResult> UserInterface::runQuery(const std::string& query) {
+    auto results = queryProcessor.processQuery(query);
+    if (queryProcessor.matchedPhrasesWithoutPositions()) {
+        std::cerr << "Note: the index has no positions; phrase matched as plain AND "
+                  << "(re-index with --positions)" << std::endl;
+    }
     displayResults(results);
+    return results;
 }
 
 void UserInterface::displayResults(const std::vector<QueryResult>& results) const {
@@ -153,6 +234,7 @@ void UserInterface::handleUICommand() {
     
     std::string command;
     std::vector<QueryResult> lastResults;
+    queryProcessor.setCache(&queryCache);
     
     while (true) {
         std::cout << "\n> ";
@@ -164,9 +246,11 @@ void UserInterface::handleUICommand() {
         else if (command == "help") {
             std::cout << "Commands:" << std::endl;
             std::cout << "  load <path>     - Load index from path" << std::endl;
-            std::cout << "  index <path>    - Index documents in directory" << std::endl;
+            std::cout << "  index <path>    - Index a directory, .json, .jsonl or .tar file" << std::endl;
             std::cout << "  save <path>     - Save index to path" << std::endl;
             std::cout << "  view <number>   - View full article from last search" << std::endl;
+            std::cout << "  explain <query> - Show how a query would be evaluated" << std::endl;
+            std::cout << "  stats           - Show query cache statistics" << std::endl;
             std::cout << "  exit/quit       - Exit program" << std::endl;
             std::cout << "  Any other input will be treated as a search query" << std::endl;
         }
@@ -185,12 +269,7 @@ void UserInterface::handleUICommand() {
             std::string path = command.substr(6);
             std::cout << "Indexing documents in " << path << "..." << std::endl;
             try {
-                if (std::filesystem::is_directory(path)) {
-                    documentParser.parseDirectory(path);
-                }
-                else {
-                    documentParser.parseJSON(path);
-                }
+                documentParser.parsePath(path);
                 std::cout << "Indexed " << indexHandler.getTotalDocuments() << " documents." << std::endl;
             }
             catch (const std::exception& e) {
@@ -208,6 +287,16 @@ void UserInterface::handleUICommand() {
                 std::cerr << "Error saving index: " << e.what() << std::endl;
             }
         }
+        else if (command.substr(0, 8) == "explain ") {
+            std::cout << queryProcessor.explain(command.substr(8));
+        }
+        else if (command == "stats") {
+            QueryCache::Stats stats = queryCache.getStats();
+            std::cout << "Query cache: " << stats.hits << " hits, " << stats.misses << " misses ("
+                      << static_cast<int>(stats.hitRate() * 100 + 0.5) << "% hit rate)" << std::endl;
+            std::cout << "  " << stats.entries << " entries, " << stats.bytes / 1024 << " KiB, "
+                      << stats.invalidations << " invalidated, " << stats.evictions << " evicted" << std::endl;
+        }
         else if (command.substr(0, 5) == "view ") {
             try {
                 int resultNum = std::stoi(command.substr(5));
@@ -230,9 +319,7 @@ void UserInterface::handleUICommand() {
                 continue;
             }
             
-            auto results = queryProcessor.processQuery(command);
-            lastResults = results;
-            displayResults(results);
+            lastResults = runQuery(command);
         }
     }
 }
\ No newline at end of file
@@ -15,15 +15,46 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 #include "../include/UserInterface.h"
 
 int main(int argc, char* argv[]) {
     try {
-        // Initialize with default stopwords file
-        const std::string stopwordsFile = "stopwords.txt";
-        UserInterface ui(stopwordsFile);
+        // Built-in stopword list unless overridden with --stopwords <file>;
+        // optional entity aliases with --aliases <file>; --positions records
+        // token positions for phrase queries; --memory-budget <MB> bounds the
+        // postings held in memory by the index command; --dedup collapses
+        // near-duplicate articles
+        std::string stopwordsFile;
+        std::string aliasesFile;
+        bool storePositions = false;
+        size_t memoryBudget = 0;
+        bool detectDuplicates = false;
+        std::vector<char*> args;
+        for (int i = 0; i < argc; ++i) {
+            if (std::string(argv[i]) == "--stopwords" && i + 1 < argc) {
+                stopwordsFile = argv[++i];
+            }
+            else if (std::string(argv[i]) == "--aliases" && i + 1 < argc) {
+                aliasesFile = argv[++i];
+            }
+            else if (std::string(argv[i]) == "--positions") {
+                storePositions = true;
+            }
+            else if (std::string(argv[i]) == "--dedup") {
+                detectDuplicates = true;
+            }
+            else if (std::string(argv[i]) == "--memory-budget" && i + 1 < argc) {
+                memoryBudget = std::stoull(argv[++i]) << 20;
+            }
+            else {
+                args.push_back(argv[i]);
+            }
+        }
         
-        return ui.run(argc, argv);
+        UserInterface ui(stopwordsFile, aliasesFile, storePositions, memoryBudget, detectDuplicates);
+        
+        return ui.run(static_cast<int>(args.size()), args.data());
     }
     catch (const std::exception& e) {
         std::cerr << "Fatal error: " << e.what() << std::endl;
@@ -0,0 +1,29 @@
+/**
+ * @file TestArticles.h
+ * @author <YourName>
+ * @brief Article fixtures shared by the ingestion and query tests
+ * @version 1.0
+ * @date 2024-03-15
+ */
+
+#pragma once
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+/**
+ * @brief JSON of an article with the given uuid and content, and placeholder other fields
+ */
+inline std::string articleJSON(const std::string& uuid, const std::string& content) {
+    return "{\"uuid\": \"" + uuid + "\", \"title\": \"t\", \"date_publish\": \"2018-01-02 00:00:00\", "
+           "\"source\": \"s\", \"content\": \"" + content + "\", "
+           "\"metadata\": {\"organizations\": [], \"persons\": []}}";
+}
+
+/**
+ * @brief Write an article file, replacing any existing one
+ */
+inline void writeArticle(const std::filesystem::path& file, const std::string& uuid, const std::string& content) {
+    std::ofstream out(file, std::ios::binary);
+    out << articleJSON(uuid, content);
+}
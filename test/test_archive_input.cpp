@@ -0,0 +1,181 @@
+/**
+ * @file test_archive_input.cpp
+ * @author <YourName>
+ * @brief Tests that tar archives and JSON-lines files index like the same articles in a directory
+ * @version 1.0
+ * @date 2024-03-15
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../include/DocumentParser.h"
+#include "../include/IndexHandler.h"
+#include "../include/StemCache.h"
+#include "../include/StopwordSet.h"
+#include "TestArticles.h"
+
+namespace fs = std::filesystem;
+
+const std::vector<std::string> kWords = {
+    "shares", "rallied", "copper", "prices", "bonds", "yields", "tariffs", "earnings", "merger", "crude",
+};
+
+// Content of a given number of words that differs from article to article
+std::string articleContent(size_t n, size_t words) {
+    std::string content;
+    for (size_t i = 0; i < words; ++i) {
+        content += (i ? " " : "") + kWords[(n * 7 + i * (n % 3 + 1)) % kWords.size()];
+    }
+    return content;
+}
+
+void writeFile(const fs::path& file, const std::string& data) {
+    std::ofstream out(file, std::ios::binary);
+    out << data;
+}
+
+// One ustar header block followed by the data, padded to whole blocks
+void writeTarEntry(std::ofstream& out, const std::string& name, char type, const std::string& data) {
+    char header[512] = {};
+    std::memcpy(header, name.data(), std::min<size_t>(name.size(), 100));
+    std::snprintf(header + 100, 8, "%07o", 0644);
+    std::snprintf(header + 108, 8, "%07o", 0);
+    std::snprintf(header + 116, 8, "%07o", 0);
+    std::snprintf(header + 124, 12, "%011lo", static_cast<unsigned long>(data.size()));
+    std::snprintf(header + 136, 12, "%011o", 0);
+    header[156] = type;
+    std::memcpy(header + 257, "ustar", 6);
+    std::memcpy(header + 263, "00", 2);
+    
+    std::memset(header + 148, ' ', 8);
+    unsigned sum = 0;
+    for (char c : header) {
+        sum += static_cast<unsigned char>(c);
+    }
+    std::snprintf(header + 148, 8, "%06o", sum);
+    header[155] = ' ';
+    
+    out.write(header, sizeof(header));
+    out << data;
+    out << std::string((512 - data.size() % 512) % 512, '\0');
+}
+
+// A pax record counts its own length, digits included
+std::string paxRecord(const std::string& key, const std::string& value) {
+    std::string body = " " + key + "=" + value + "\n";
+    size_t length = body.size() + 1;
+    while (std::to_string(length).size() + body.size() != length) {
+        ++length;
+    }
+    return std::to_string(length) + body;
+}
+
+// Directory ingestion reads the month subdirectories of the given directory
+size_t indexDirectory(const fs::path& directory, IndexHandler& index) {
+    StopwordSet stopwords;
+    DocumentParser parser(index, stopwords);
+    parser.parseDirectory(directory.string());
+    return index.getTotalDocuments();
+}
+
+void assertSameDocuments([[maybe_unused]] const IndexHandler& expected, [[maybe_unused]] const IndexHandler& actual,
+                         const std::vector<std::string>& uuids) {
+    assert(expected.getTotalDocuments() == uuids.size());
+    assert(actual.getTotalDocuments() == uuids.size());
+    for ([[maybe_unused]] const auto& uuid : uuids) {
+        assert(expected.hasDocument(uuid) && actual.hasDocument(uuid));
+        assert(expected.getDocumentLength(expected.findDocument(uuid)) ==
+               actual.getDocumentLength(actual.findDocument(uuid)));
+    }
+    for (std::string word : kWords) {
+        StemCache::shared().stem(word);
+        assert(expected.getDocumentFrequency(word) == actual.getDocumentFrequency(word));
+    }
+}
+
+void test_tar_matches_directory() {
+    fs::path root = fs::temp_directory_path() / "test_archive_input_tar";
+    fs::remove_all(root);
+    fs::create_directories(root / "articles" / "2018_01");
+    
+    const std::vector<std::string> uuids = {"uuid-short", "uuid-gnu", "uuid-pax"};
+    std::vector<std::string> articles;
+    for (size_t n = 0; n < uuids.size(); ++n) {
+        articles.push_back(articleJSON(uuids[n], articleContent(n, 20 + n)));
+        writeFile(root / "articles" / "2018_01" / (std::to_string(n) + ".json"), articles[n]);
+    }
+    
+    // Paths over the 100 bytes of the name field need a GNU long name or a pax path
+    std::string longPath = "2018_01/" + std::string(120, 'x') + "/article.json";
+    fs::path archive = root / "articles.tar";
+    {
+        std::ofstream out(archive, std::ios::binary);
+        writeTarEntry(out, "short/", '5', "");
+        writeTarEntry(out, "short/a.json", '0', articles[0]);
+        writeTarEntry(out, "././@LongLink", 'L', "gnu/" + longPath + '\0');
+        writeTarEntry(out, ("gnu/" + longPath).substr(0, 100), '0', articles[1]);
+        writeTarEntry(out, "PaxHeaders/article", 'x', paxRecord("mtime", "0") + paxRecord("path", "pax/" + longPath));
+        writeTarEntry(out, "pax-truncated-name", '0', articles[2]);
+        writeTarEntry(out, "short/notes.txt", '0', "not an article");
+        out << std::string(1024, '\0');
+    }
+    
+    IndexHandler fromDirectory;
+    indexDirectory(root / "articles", fromDirectory);
+    
+    IndexHandler fromTar;
+    StopwordSet stopwords;
+    DocumentParser parser(fromTar, stopwords);
+    parser.parseTar(archive.string());
+    assertSameDocuments(fromDirectory, fromTar, uuids);
+    
+    fs::remove_all(root);
+}
+
+void test_jsonl_matches_directory() {
+    fs::path root = fs::temp_directory_path() / "test_archive_input_jsonl";
+    fs::remove_all(root);
+    fs::create_directories(root / "articles" / "2018_01");
+    
+    // About 6 MB of lines, so lines straddle the 4 MB read chunk, then one line
+    // longer than a chunk, which makes the reader grow its buffer, left without
+    // a trailing newline
+    std::vector<std::string> uuids;
+    fs::path lines = root / "articles.jsonl";
+    {
+        std::ofstream out(lines, std::ios::binary);
+        for (size_t n = 0; n < 1501; ++n) {
+            uuids.push_back("uuid-" + std::to_string(n));
+            size_t words = n < 1500 ? 300 + n % 400 : 700000;
+            std::string article = articleJSON(uuids.back(), articleContent(n, words));
+            writeFile(root / "articles" / "2018_01" / (std::to_string(n) + ".json"), article);
+            out << article << (n < 1500 ? "\n" : "");
+        }
+    }
+    assert(fs::file_size(lines) > (8u << 20));
+    
+    IndexHandler fromDirectory;
+    indexDirectory(root / "articles", fromDirectory);
+    
+    IndexHandler fromLines;
+    StopwordSet stopwords;
+    DocumentParser parser(fromLines, stopwords);
+    parser.parseJSONLines(lines.string());
+    assertSameDocuments(fromDirectory, fromLines, uuids);
+    
+    fs::remove_all(root);
+}
+
+int main() {
+    std::cout << "Running archive input tests..." << std::endl;
+    test_tar_matches_directory();
+    test_jsonl_matches_directory();
+    std::cout << "All archive input tests passed!" << std::endl;
+    return 0;
+}
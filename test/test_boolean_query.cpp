@@ -0,0 +1,151 @@
+/**
+ * @file test_boolean_query.cpp
+ * @author <YourName>
+ * @brief Tests the boolean query grammar and its posting iterators against set algebra
+ * @version 1.0
+ * @date 2024-03-15
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "../include/IndexHandler.h"
+#include "../include/PostingIterator.h"
+#include "../include/QueryProcessor.h"
+#include "../include/StemCache.h"
+#include "../include/StopwordSet.h"
+
+using DocSet = std::vector<uint32_t>;
+using Ids = std::set<std::string>;
+
+PostingList randomList(std::mt19937& rng, double density) {
+    std::bernoulli_distribution keep(density);
+    PostingList list;
+    for (uint32_t doc = 0; doc < 3000; ++doc) {
+        if (keep(rng)) {
+            list.postings.push_back({doc, 1});
+        }
+    }
+    return list;
+}
+
+DocSet docsOf(const PostingList& list) {
+    DocSet docs;
+    for (const auto& posting : list.postings) {
+        docs.push_back(posting.doc);
+    }
+    return docs;
+}
+
+// Drain an iterator, mixing next() with occasional advance() jumps
+DocSet drain(PostingIterator& iterator, std::mt19937& rng, const DocSet& expected) {
+    DocSet docs;
+    for (uint32_t doc = iterator.doc(); doc != PostingIterator::kEnd; ) {
+        docs.push_back(doc);
+        if (rng() % 4 == 0) {
+            uint32_t target = doc + 1 + rng() % 50;
+            doc = iterator.advance(target);
+            // Skipped documents are not reported
+            auto skipped = std::lower_bound(expected.begin(), expected.end(), target);
+            docs.insert(docs.end(), std::upper_bound(expected.begin(), expected.end(), docs.back()), skipped);
+        }
+        else {
+            doc = iterator.next();
+        }
+    }
+    return docs;
+}
+
+void test_iterators_match_set_algebra() {
+    std::mt19937 rng(49);
+    const double densities[] = {0.002, 0.02, 0.2, 0.6};
+    
+    for (int round = 0; round < 200; ++round) {
+        PostingList a = randomList(rng, densities[rng() % 4]);
+        PostingList b = randomList(rng, densities[rng() % 4]);
+        PostingList c = randomList(rng, densities[rng() % 4]);
+        DocSet docsA = docsOf(a), docsB = docsOf(b), docsC = docsOf(c);
+        
+        // (a AND b) OR c, minus (b AND c)
+        DocSet ab, abOrC, bc, expected;
+        std::set_intersection(docsA.begin(), docsA.end(), docsB.begin(), docsB.end(), std::back_inserter(ab));
+        std::set_union(ab.begin(), ab.end(), docsC.begin(), docsC.end(), std::back_inserter(abOrC));
+        std::set_intersection(docsB.begin(), docsB.end(), docsC.begin(), docsC.end(), std::back_inserter(bc));
+        std::set_difference(abOrC.begin(), abOrC.end(), bc.begin(), bc.end(), std::back_inserter(expected));
+        
+        std::vector<PostingIteratorPtr> both;
+        both.push_back(std::make_unique<ListIterator>(a, 1.0));
+        both.push_back(std::make_unique<ListIterator>(b, 1.0));
+        std::vector<PostingIteratorPtr> either;
+        either.push_back(std::make_unique<AndIterator>(std::move(both)));
+        either.push_back(std::make_unique<ListIterator>(c, 1.0));
+        std::vector<PostingIteratorPtr> excluded;
+        excluded.push_back(std::make_unique<ListIterator>(b, 1.0));
+        excluded.push_back(std::make_unique<ListIterator>(c, 1.0));
+        AndNotIterator query(std::make_unique<OrIterator>(std::move(either)),
+                             std::make_unique<AndIterator>(std::move(excluded)));
+        
+        assert(drain(query, rng, expected) == expected);
+    }
+}
+
+void test_grammar() {
+    // Each document holds the words named in its title
+    const std::vector<std::vector<std::string>> documents = {
+        {"oil", "opec"}, {"oil", "bank"}, {"gas", "bank"}, {"gas"}, {"bank", "rate"}, {"oil", "gas", "rate"},
+    };
+    IndexHandler index;
+    for (uint32_t n = 0; n < documents.size(); ++n) {
+        uint32_t doc = index.registerDocument("doc-" + std::to_string(n));
+        index.addDocumentMetadata(doc, "title", 0, "source");
+        index.setDocumentLength(doc, 10);
+        for (std::string term : documents[n]) {
+            StemCache::shared().stem(term);
+            index.addTerm(term, doc, 1);
+        }
+    }
+    index.addOrganization("Goldman Sachs", 1);
+    index.addOrganization("Goldman Sachs", 4);
+    index.buildScoreBounds();
+    
+    StopwordSet stopwords;
+    QueryProcessor processor(index, stopwords);
+    [[maybe_unused]] auto matches = [&processor](const std::string& query) {
+        Ids ids;
+        for (const auto& result : processor.processQuery(query)) {
+            ids.insert(result.docID);
+        }
+        return ids;
+    };
+    
+    assert((matches("(oil OR gas) AND NOT bank") == Ids{"doc-0", "doc-3", "doc-5"}));
+    assert((matches("(oil OR gas) -bank -rate") == Ids{"doc-0", "doc-3"}));
+    assert((matches("oil gas OR bank rate") == Ids{"doc-5", "doc-4"}));
+    assert((matches("oil AND (opec OR ORG:Goldman_Sachs)") == Ids{"doc-0", "doc-1"}));
+    assert((matches("bank NOT (gas OR ORG:goldman_sachs)") == Ids{}));
+    assert((matches("bank NOT (gas OR rate)") == Ids{"doc-1"}));
+    assert((matches("((oil)) OR (gas") == Ids{"doc-0", "doc-1", "doc-2", "doc-3", "doc-5"}));
+    assert((matches("NOT oil") == Ids{}));
+    assert((matches("rate OR NOT oil") == Ids{"doc-4", "doc-5"}));
+    
+    // Equally scored expressions in any order rank identically
+    auto first = processor.processQuery("(bank OR rate) gas -opec");
+    auto second = processor.processQuery("gas -opec (rate OR bank)");
+    assert(first.size() == second.size());
+    for (size_t i = 0; i < first.size(); ++i) {
+        assert(first[i].docID == second[i].docID && first[i].score == second[i].score);
+    }
+}
+
+int main() {
+    std::cout << "Running boolean query tests..." << std::endl;
+    test_iterators_match_set_algebra();
+    test_grammar();
+    std::cout << "All boolean query tests passed!" << std::endl;
+    return 0;
+}
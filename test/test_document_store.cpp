@@ -0,0 +1,79 @@
+/**
+ * @file test_document_store.cpp
+ * @author <YourName>
+ * @brief Tests for date parsing, string pooling and persistence of document metadata
+ * @version 1.0
+ * @date 2024-03-15
+ */
+
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <cstdio>
+#include "../include/DocumentStore.h"
+
+void test_dates() {
+    assert(DocumentStore::parseDate("1970-01-01") == 0);
+    assert(DocumentStore::parseDate("2018-01-21 03:44:00") == 1516506240);
+    assert(DocumentStore::parseDate("2018-01-21T03:44") == 1516506240);
+    assert(DocumentStore::parseDate("2018-01-21T03:44:00Z") == 1516506240);
+    assert(DocumentStore::parseDate("2018-01-21T05:44:00.000+02:00") == 1516506240);
+    assert(DocumentStore::parseDate("2018-01-20T22:44:00-0500") == 1516506240);
+    assert(DocumentStore::parseDate("1969-12-31 23:59:59") == -1);
+    
+    assert(DocumentStore::parseDate("") == DocumentStore::kUnknownDate);
+    assert(DocumentStore::parseDate("Unknown Date") == DocumentStore::kUnknownDate);
+    assert(DocumentStore::parseDate("2018-02-30") == DocumentStore::kUnknownDate);
+    assert(DocumentStore::parseDate("2018-01-21 25:00") == DocumentStore::kUnknownDate);
+    
+    assert(DocumentStore::formatDate(1516506240) == "2018-01-21 03:44:00");
+    assert(DocumentStore::formatDate(-1) == "1969-12-31 23:59:59");
+    assert(DocumentStore::formatDate(DocumentStore::kUnknownDate) == "Unknown Date");
+    assert(DocumentStore::formatDate(DocumentStore::parseDate("2024-02-29 12:00:01")) == "2024-02-29 12:00:01");
+}
+
+void test_store_and_round_trip() {
+    const char* filename = "test_documents.bin";
+    
+    DocumentStore original;
+    for (int i = 0; i < 3; ++i) {
+        original.add();
+    }
+    original.set(0, "Fed holds rates", DocumentStore::parseDate("2018-01-21 03:44:00"), "reuters.com");
+    original.set(2, "Stocks rally", DocumentStore::kUnknownDate, "reuters.com");
+    
+    [[maybe_unused]] DocumentView view = original.get(0);
+    assert(view.title == "Fed holds rates" && view.source == "reuters.com" && view.published == 1516506240);
+    assert(original.get(1).title.empty() && original.get(1).source.empty());
+    assert(original.get(5).title.empty() && original.get(5).published == DocumentStore::kUnknownDate);
+    assert(original.info(0).source == original.info(2).source);
+    
+    original.erase(0);
+    assert(original.get(0).title.empty());
+    {
+        std::ofstream out(filename, std::ios::binary);
+        original.write(out);
+    }
+    
+    DocumentStore loaded;
+    {
+        std::ifstream in(filename, std::ios::binary);
+        loaded.read(in);
+    }
+    std::remove(filename);
+    
+    assert(loaded.size() == 3);
+    assert(loaded.get(2).title == "Stocks rally" && loaded.get(2).source == "reuters.com");
+    assert(loaded.get(2).published == DocumentStore::kUnknownDate);
+    loaded.add();
+    loaded.set(3, "Oil slips", 0, "wsj.com");
+    assert(loaded.info(3).source != loaded.info(2).source && loaded.get(3).source == "wsj.com");
+}
+
+int main() {
+    std::cout << "Running document store tests..." << std::endl;
+    test_dates();
+    test_store_and_round_trip();
+    std::cout << "All document store tests passed!" << std::endl;
+    return 0;
+}
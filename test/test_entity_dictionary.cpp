@@ -0,0 +1,87 @@
+/**
+ * @file test_entity_dictionary.cpp
+ * @author <YourName>
+ * @brief Tests for entity name normalization, aliasing and persistence
+ * @version 1.0
+ * @date 2024-03-15
+ */
+
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <cstdio>
+#include "../include/EntityDictionary.h"
+
+void test_normalize() {
+    assert(EntityDictionary::normalize("Goldman Sachs") == "goldman sachs");
+    assert(EntityDictionary::normalize("  GOLDMAN \t\n Sachs  ") == "goldman sachs");
+    assert(EntityDictionary::normalize("elon_musk") == "elon musk");
+    assert(EntityDictionary::normalize("Soci\xC3\xA9t\xC3\xA9 G\xC3\xA9n\xC3\xA9rale") == "soci\xC3\xA9t\xC3\xA9 g\xC3\xA9n\xC3\xA9rale");
+    assert(EntityDictionary::normalize("SOCI\xC3\x89T\xC3\x89 G\xC3\x89N\xC3\x89RALE") == "soci\xC3\xA9t\xC3\xA9 g\xC3\xA9n\xC3\xA9rale");
+    assert(EntityDictionary::normalize("\xD0\x93\xD0\xB0\xD0\xB7\xD0\xBF\xD1\x80\xD0\xBE\xD0\xBC") == "\xD0\xB3\xD0\xB0\xD0\xB7\xD0\xBF\xD1\x80\xD0\xBE\xD0\xBC");
+    assert(EntityDictionary::normalize("AT&T") == "at&t");
+    assert(EntityDictionary::normalize(" \t ") == "");
+}
+
+void test_intern_and_aliases() {
+    EntityDictionary dictionary;
+    dictionary.addAlias("Alphabet Inc", "Google");
+    dictionary.addAlias("Alphabet", "alphabet inc");
+    
+    [[maybe_unused]] uint32_t google = dictionary.intern("Google");
+    assert(google == 0);
+    for (const char* name : {"GOOGLE", "Alphabet  Inc", "alphabet"}) {
+        [[maybe_unused]] uint32_t id = dictionary.intern(name);
+        assert(id == google);
+    }
+    assert(dictionary.name(google) == "google");
+    
+    [[maybe_unused]] uint32_t tesla = dictionary.intern("Tesla");
+    assert(tesla == 1);
+    assert(dictionary.size() == 2);
+    
+    assert(dictionary.lookup("tesla") == tesla);
+    [[maybe_unused]] uint32_t societe = dictionary.intern("Soci\xC3\xA9t\xC3\xA9 G\xC3\xA9n\xC3\xA9rale");
+    assert(dictionary.lookup("SOCI\xC3\x89T\xC3\x89_G\xC3\x89N\xC3\x89RALE") == societe);
+    assert(dictionary.lookup("Apple") == EntityDictionary::kUnknown);
+    assert(dictionary.size() == 3);
+    
+    // Alias cycles resolve without looping
+    dictionary.addAlias("a", "b");
+    dictionary.addAlias("b", "a");
+    dictionary.intern("a");
+}
+
+void test_round_trip() {
+    const char* filename = "test_entities.bin";
+    
+    EntityDictionary original;
+    original.addAlias("Facebook", "Meta Platforms");
+    original.intern("Meta Platforms");
+    original.intern("Tesla");
+    {
+        std::ofstream out(filename, std::ios::binary);
+        original.write(out);
+    }
+    
+    EntityDictionary loaded;
+    loaded.addAlias("TSLA", "Tesla");
+    {
+        std::ifstream in(filename, std::ios::binary);
+        loaded.read(in);
+    }
+    std::remove(filename);
+    
+    assert(loaded.size() == 2);
+    assert(loaded.lookup("facebook") == original.lookup("Meta Platforms"));
+    assert(loaded.lookup("TSLA") == original.lookup("Tesla"));
+}
+
+int main() {
+    std::cout << "Running entity dictionary tests..." << std::endl;
+    test_normalize();
+    test_intern_and_aliases();
+    test_round_trip();
+    std::cout << "All entity dictionary tests passed!" << std::endl;
+    return 0;
+}
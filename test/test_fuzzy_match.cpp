@@ -0,0 +1,145 @@
+/**
+ * @file test_fuzzy_match.cpp
+ * @author <YourName>
+ * @brief Tests fuzzy word lookup against brute-force edit distances
+ * @version 1.0
+ * @date 2024-03-15
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "../include/IndexHandler.h"
+#include "../include/LevenshteinAutomaton.h"
+#include "../include/QueryProcessor.h"
+#include "../include/StemCache.h"
+#include "../include/StopwordSet.h"
+
+size_t editDistance(const std::string& a, const std::string& b) {
+    std::vector<size_t> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) {
+        row[j] = j;
+    }
+    for (size_t i = 1; i <= a.size(); ++i) {
+        size_t diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); ++j) {
+            size_t above = row[j];
+            row[j] = std::min({above + 1, row[j - 1] + 1, diagonal + (a[i - 1] == b[j - 1] ? 0 : 1)});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+void test_automaton() {
+    LevenshteinAutomaton automaton("economi", 2);
+    uint32_t state = automaton.start();
+    for (char c : std::string("ecomoni")) {
+        state = automaton.step(state, static_cast<unsigned char>(c));
+    }
+    assert(automaton.distance(state) == 2);
+    
+    // Transitions are remembered, so the same input reaches the same state
+    [[maybe_unused]] size_t states = automaton.stateCount();
+    uint32_t again = automaton.start();
+    for (char c : std::string("ecomoni")) {
+        again = automaton.step(again, static_cast<unsigned char>(c));
+    }
+    assert(again == state && automaton.stateCount() == states);
+    
+    state = automaton.start();
+    for (char c : std::string("xyz")) {
+        state = automaton.step(state, static_cast<unsigned char>(c));
+    }
+    assert(!automaton.canMatch(state));
+}
+
+void test_matches_brute_force() {
+    std::mt19937 rng(50);
+    std::uniform_int_distribution<int> length(1, 9);
+    std::uniform_int_distribution<int> letter(0, 5);  // a small alphabet makes near words common
+    
+    IndexHandler index;
+    std::set<std::string> vocabulary;
+    uint32_t doc = index.registerDocument("doc");
+    for (int i = 0; i < 5000; ++i) {
+        std::string word(length(rng), 'a');
+        for (auto& c : word) {
+            c = static_cast<char>('a' + letter(rng));
+        }
+        vocabulary.insert(word);
+        index.addTerm(word, doc, 1);
+    }
+    
+    // First walking the word index, then through the trie
+    for (int pass = 0; pass < 2; ++pass) {
+        if (pass == 1) {
+            index.buildWordTrie();
+        }
+        for (int round = 0; round < 100; ++round) {
+            std::string term(length(rng), 'a');
+            for (auto& c : term) {
+                c = static_cast<char>('a' + letter(rng));
+            }
+            for (uint32_t edits = 0; edits <= 2; ++edits) {
+                std::vector<std::string> found = index.findSimilarWords(term, edits, SIZE_MAX);
+                std::set<std::string> expected;
+                for (const auto& word : vocabulary) {
+                    if (editDistance(term, word) <= edits) {
+                        expected.insert(word);
+                    }
+                }
+                assert(std::set<std::string>(found.begin(), found.end()) == expected);
+                assert(found.size() == expected.size());
+                for (size_t i = 1; i < found.size(); ++i) {
+                    assert(editDistance(term, found[i - 1]) <= editDistance(term, found[i]));
+                }
+            }
+        }
+    }
+    assert(index.findSimilarWords("abc", 2, 3).size() <= 3);
+}
+
+void test_fuzzy_queries() {
+    IndexHandler index;
+    const std::vector<std::vector<std::string>> documents = {
+        {"nvidia", "chips"}, {"economy", "growth"}, {"economy", "nvidia"},
+    };
+    for (uint32_t n = 0; n < documents.size(); ++n) {
+        uint32_t doc = index.registerDocument("doc-" + std::to_string(n));
+        index.addDocumentMetadata(doc, "title", 0, "source");
+        index.setDocumentLength(doc, 10);
+        for (std::string term : documents[n]) {
+            StemCache::shared().stem(term);
+            index.addTerm(term, doc, 1);
+        }
+    }
+    
+    StopwordSet stopwords;
+    QueryProcessor processor(index, stopwords);
+    
+    // ~3 and ~0 are not fuzzy: the token stays a plain (unindexed) word
+    const std::vector<std::pair<std::string, size_t>> expected = {
+        {"nvidai", 0}, {"nvidai~2", 2}, {"nvidai~1", 0}, {"nvidai~3", 0}, {"nvidai~0", 0},
+        {"ecomony~ growth", 1}, {"ecomony~2 AND nvidai~2", 1},
+    };
+    for (const auto& [query, size] : expected) {
+        [[maybe_unused]] size_t found = processor.processQuery(query).size();
+        assert(found == size);
+    }
+    assert(processor.explain("nvidai~3").find("nvidia") == std::string::npos);
+}
+
+int main() {
+    std::cout << "Running fuzzy match tests..." << std::endl;
+    test_automaton();
+    test_matches_brute_force();
+    test_fuzzy_queries();
+    std::cout << "All fuzzy match tests passed!" << std::endl;
+    return 0;
+}
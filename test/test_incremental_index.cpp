@@ -0,0 +1,173 @@
+/**
+ * @file test_incremental_index.cpp
+ * @author <YourName>
+ * @brief Tests that re-indexing a directory with its manifest parses only what changed
+ * @version 1.0
+ * @date 2024-03-15
+ */
+
+#include <iostream>
+#include <cassert>
+#include <filesystem>
+#include <string>
+#include "../include/DocumentParser.h"
+#include "../include/IndexHandler.h"
+#include "../include/Manifest.h"
+#include "../include/QueryProcessor.h"
+#include "../include/StopwordSet.h"
+#include "TestArticles.h"
+
+namespace fs = std::filesystem;
+
+// Index the directory, starting from the saved index and manifest if they exist
+size_t indexDirectory(const fs::path& directory, const std::string& base, IndexHandler& index) {
+    StopwordSet stopwords;
+    DocumentParser parser(index, stopwords);
+    Manifest manifest;
+    if (manifest.load(base + ".manifest") && manifest.matches(directory.string(), false, false)) {
+        index.loadIndices(base);
+    }
+    else {
+        manifest.reset(directory.string(), false, false);
+    }
+    parser.parseDirectory(directory.string(), &manifest);
+    index.saveIndices(base);
+    manifest.save(base + ".manifest");
+    return parser.getIngestStats().files;
+}
+
+void test_incremental_update() {
+    fs::path directory = fs::temp_directory_path() / "test_incremental_index";
+    fs::remove_all(directory);
+    fs::create_directories(directory / "2018_01");
+    fs::create_directories(directory / "2018_02");
+    writeArticle(directory / "2018_01" / "a.json", "uuid-a", "tesla shares rallied");
+    writeArticle(directory / "2018_01" / "b.json", "uuid-b", "copper prices slumped");
+    writeArticle(directory / "2018_02" / "c.json", "uuid-c", "bond yields climbed");
+    std::string base = (directory / "index").string();
+    
+    {
+        IndexHandler index;
+        [[maybe_unused]] size_t indexed = indexDirectory(directory, base, index);
+        assert(indexed == 3);
+        assert(index.getTotalDocuments() == 3);
+    }
+    
+    // Nothing changed: nothing is parsed
+    {
+        IndexHandler index;
+        [[maybe_unused]] size_t indexed = indexDirectory(directory, base, index);
+        assert(indexed == 0);
+        assert(index.getTotalDocuments() == 3);
+    }
+    
+    // Edit a (same uuid), remove b, add d
+    writeArticle(directory / "2018_01" / "a.json", "uuid-a", "tesla shares tumbled sharply");
+    fs::remove(directory / "2018_01" / "b.json");
+    writeArticle(directory / "2018_02" / "d.json", "uuid-d", "oil output rose");
+    {
+        IndexHandler index;
+        [[maybe_unused]] size_t indexed = indexDirectory(directory, base, index);
+        assert(indexed == 2);
+        assert(index.getTotalDocuments() == 3);
+        assert(index.getDeletedCount() == 2);
+        assert(!index.hasDocument("uuid-b"));
+        
+        [[maybe_unused]] uint32_t a = index.findDocument("uuid-a");
+        assert(a != IndexHandler::kNoDocument && !index.isDeleted(a));
+        [[maybe_unused]] const PostingList* tumbled = index.getWordPostings("tumbl");
+        assert(tumbled && tumbled->postings.size() == 1 && tumbled->postings[0].doc == a);
+        
+        // Postings of the old versions stay, tombstoned
+        [[maybe_unused]] const PostingList* rallied = index.getWordPostings("ralli");
+        assert(rallied && rallied->postings.size() == 1 && index.isDeleted(rallied->postings[0].doc));
+        assert(index.getDocumentFrequency("ralli") == 0);
+        assert(index.getDocumentFrequency("tesla") == 1);
+    }
+    
+    // Tombstones survive a save and load
+    {
+        IndexHandler index;
+        index.loadIndices(base);
+        assert(index.getTotalDocuments() == 3);
+        assert(index.getDeletedCount() == 2);
+        assert(index.hasDocument("uuid-a") && !index.hasDocument("uuid-b"));
+        assert(index.getDocumentFrequency("tesla") == 1);
+    }
+    
+    fs::remove_all(directory);
+}
+
+// Tombstones must not count toward document frequencies, or IDF turns negative
+void test_deleted_documents_keep_scores_positive() {
+    IndexHandler index;
+    for (uint32_t n = 0; n < 40; ++n) {
+        uint32_t doc = index.registerDocument("doc-" + std::to_string(n));
+        index.setDocumentLength(doc, 100);
+        index.addTerm("market", doc, 1 + n % 5);
+    }
+    std::vector<uint32_t> deleted;
+    for (uint32_t n = 0; n < 36; ++n) {
+        deleted.push_back(n);
+    }
+    index.deleteDocuments(deleted);
+    assert(index.getTotalDocuments() == 4);
+    assert(index.getDocumentFrequency("market") == 4);
+    
+    StopwordSet stopwords;
+    QueryProcessor processor(index, stopwords);
+    processor.setPruning(false);
+    auto results = processor.processQuery("market");
+    assert(results.size() == 4);
+    
+    // More occurrences rank higher: doc-39 has tf 5, doc-36 tf 2
+    const std::vector<std::string> expected = {"doc-39", "doc-38", "doc-37", "doc-36"};
+    for (size_t i = 0; i < results.size(); ++i) {
+        assert(results[i].docID == expected[i]);
+        assert(results[i].score > 0.0);
+    }
+}
+
+// Entity and bigram lists count only live documents too, also once bigrams are rebuilt
+void test_deleted_documents_leave_entity_and_bigram_df() {
+    IndexHandler index;
+    auto addArticle = [&index](uint32_t n) {
+        uint32_t doc = index.registerDocument("doc-" + std::to_string(n));
+        index.setDocumentLength(doc, 2);
+        const uint32_t first = 0, second = 1;
+        index.addTermPositions("bank", doc, &first, 1);
+        index.addTermPositions("rate", doc, &second, 1);
+        index.countBigram("bank", "rate", 1);
+        index.addOrganization("Goldman Sachs", doc);
+    };
+    for (uint32_t n = 0; n < 10; ++n) {
+        addArticle(n);
+    }
+    index.buildBigramIndex();
+    assert(index.getBigramPostings("bank", "rate") != nullptr);
+    
+    index.deleteDocuments({0, 1, 2, 3, 4, 5});
+    [[maybe_unused]] const PostingList* organization = index.getOrganizationPostings("goldman sachs");
+    [[maybe_unused]] const PostingList* bigram = index.getBigramPostings("bank", "rate");
+    assert(organization && organization->documentFrequency() == 4);
+    assert(bigram && bigram->documentFrequency() == 4);
+    
+    addArticle(10);
+    index.buildBigramIndex();
+    bigram = index.getBigramPostings("bank", "rate");
+    assert(bigram && bigram->postings.size() == 11 && bigram->documentFrequency() == 5);
+    
+    StopwordSet stopwords;
+    QueryProcessor processor(index, stopwords);
+    [[maybe_unused]] std::string plan = processor.explain("\"bank rate\" ORG:goldman_sachs");
+    assert(plan.find("df 5") != std::string::npos && plan.find("df 11") == std::string::npos);
+}
+
+int main() {
+    std::cout << "Running incremental index tests..." << std::endl;
+    test_incremental_update();
+    test_deleted_documents_keep_scores_positive();
+    test_deleted_documents_leave_entity_and_bigram_df();
+    std::cout << "All incremental index tests passed!" << std::endl;
+    return 0;
+}
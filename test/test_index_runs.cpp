@@ -0,0 +1,128 @@
+/**
+ * @file test_index_runs.cpp
+ * @author <YourName>
+ * @brief Tests that memory-bounded indexing saves the same index as in-memory indexing
+ * @version 1.0
+ * @date 2024-03-15
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../include/IndexHandler.h"
+
+// Small deterministic corpus: document d contains words drawn from a short vocabulary
+void addDocuments(IndexHandler& index, uint32_t count) {
+    const std::vector<std::string> vocabulary = {"bank", "rate", "stock", "market", "china", "growth", "fed"};
+    std::vector<uint32_t> positions;
+    
+    for (uint32_t n = 0; n < count; ++n) {
+        uint32_t doc = index.registerDocument("doc-" + std::to_string(n));
+        index.setDocumentLength(doc, 12);
+        
+        // Word w appears at positions w, w + 7, ... while they stay below a per-document length
+        uint32_t length = 8 + n % 7;
+        for (uint32_t w = 0; w < vocabulary.size(); ++w) {
+            if ((n + w) % 3 == 0) {
+                continue;
+            }
+            positions.clear();
+            for (uint32_t position = w; position < length; position += 7) {
+                positions.push_back(position);
+            }
+            index.addTermPositions(vocabulary[w], doc, positions.data(), static_cast<uint32_t>(positions.size()));
+        }
+        for (uint32_t w = 0; w + 1 < vocabulary.size(); ++w) {
+            if ((n + w) % 3 != 0 && (n + w + 1) % 3 != 0) {
+                index.countBigram(vocabulary[w], vocabulary[w + 1], 1);
+            }
+        }
+        index.addOrganization(n % 2 ? "Tesla" : "Goldman Sachs", doc);
+    }
+}
+
+bool samePostings(const PostingList* a, const PostingList* b) {
+    if (!a || !b) {
+        return a == b;
+    }
+    if (a->postings.size() != b->postings.size() || a->positionData != b->positionData ||
+        a->positionOffsets != b->positionOffsets) {
+        return false;
+    }
+    for (size_t i = 0; i < a->postings.size(); ++i) {
+        if (a->postings[i].doc != b->postings[i].doc || a->postings[i].tf != b->postings[i].tf) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_spilled_index_matches() {
+    IndexHandler inMemory;
+    inMemory.setStorePositions(true);
+    addDocuments(inMemory, 200);
+    inMemory.buildBigramIndex();
+    inMemory.saveIndices("test_runs_memory");
+    
+    // A one-byte budget spills a run before every document
+    IndexHandler spilled;
+    spilled.setStorePositions(true);
+    spilled.setMemoryBudget(1);
+    addDocuments(spilled, 200);
+    assert(spilled.getRunCount() == 199);
+    spilled.buildBigramIndex();
+    spilled.saveIndices("test_runs_spilled");
+    assert(spilled.getRunCount() == 0);
+    
+    IndexHandler expected, actual;
+    expected.loadIndices("test_runs_memory");
+    actual.loadIndices("test_runs_spilled");
+    
+    assert(actual.getTotalDocuments() == 200);
+    for ([[maybe_unused]] const char* word : {"bank", "rate", "stock", "market", "china", "growth", "fed", "missing"}) {
+        assert(samePostings(expected.getWordPostings(word), actual.getWordPostings(word)));
+    }
+    assert(actual.getBigramPostings("bank", "rate") != nullptr);
+    for ([[maybe_unused]] const char* first : {"bank", "stock", "china"}) {
+        for ([[maybe_unused]] const char* second : {"rate", "market", "growth"}) {
+            assert(samePostings(expected.getBigramPostings(first, second), actual.getBigramPostings(first, second)));
+        }
+    }
+    assert(samePostings(expected.getOrganizationPostings("tesla"), actual.getOrganizationPostings("tesla")));
+    
+    for (const char* base : {"test_runs_memory", "test_runs_spilled"}) {
+        for (const char* extension : {".words", ".bigrams", ".orgs", ".persons", ".meta"}) {
+            std::remove((std::string(base) + extension).c_str());
+        }
+    }
+}
+
+void test_append_keeps_positions() {
+    uint32_t first[] = {1, 4};
+    uint32_t second[] = {0, 9, 300};
+    PostingList a, b;
+    a.addWithPositions(3, first, 2);
+    b.addWithPositions(7, second, 3);
+    a.append(b);
+    
+    assert(a.hasPositions());
+    std::vector<uint32_t> positions;
+    a.decodePositions(1, positions);
+    assert(positions == std::vector<uint32_t>({0, 9, 300}));
+    
+    // Joining with a list without positions drops them
+    PostingList plain;
+    plain.add(9, 2);
+    a.append(plain);
+    assert(a.postings.size() == 3 && !a.hasPositions());
+}
+
+int main() {
+    std::cout << "Running index run tests..." << std::endl;
+    test_append_keeps_positions();
+    test_spilled_index_matches();
+    std::cout << "All index run tests passed!" << std::endl;
+    return 0;
+}
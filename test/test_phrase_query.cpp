@@ -0,0 +1,164 @@
+/**
+ * @file test_phrase_query.cpp
+ * @author <YourName>
+ * @brief Tests for phrase and proximity queries over positional postings
+ * @version 1.0
+ * @date 2024-03-15
+ */
+
+#include <iostream>
+#include <cassert>
+#include <filesystem>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "../include/DocumentParser.h"
+#include "../include/IndexHandler.h"
+#include "../include/QueryProcessor.h"
+#include "../include/StopwordSet.h"
+#include "TestArticles.h"
+
+namespace fs = std::filesystem;
+
+const std::vector<std::pair<std::string, std::string>> kArticles = {
+    {"d1", "interest rates rose as inflation climbed"},
+    {"d2", "rates on interest climbed"},
+    {"d3", "interest in rates"},
+    {"d4", "bank of england raised rates"},
+    {"d5", "bank england merger"},
+    {"d6", "rates held steady while the inflation outlook improved"},
+};
+
+using Articles = std::vector<std::pair<std::string, std::string>>;
+using Documents = std::set<std::string>;
+
+void buildIndex(IndexHandler& index, bool positions, const Articles& articles = kArticles) {
+    fs::path directory = fs::temp_directory_path() / "test_phrase_query";
+    fs::remove_all(directory);
+    fs::create_directories(directory / "2018_01");
+    for (const auto& [uuid, content] : articles) {
+        writeArticle(directory / "2018_01" / (uuid + ".json"), uuid, content);
+    }
+    
+    StopwordSet stopwords;
+    DocumentParser parser(index, stopwords);
+    index.setStorePositions(positions);
+    parser.parsePath(directory.string());
+    fs::remove_all(directory);
+}
+
+Documents matches(QueryProcessor& processor, const std::string& query) {
+    Documents documents;
+    for (const auto& result : processor.processQuery(query)) {
+        documents.insert(result.docID);
+    }
+    return documents;
+}
+
+void test_phrases_and_proximity() {
+    IndexHandler index;
+    buildIndex(index, true);
+    StopwordSet stopwords;
+    QueryProcessor processor(index, stopwords);
+    
+    assert(matches(processor, "\"interest rates\"") == Documents({"d1"}));
+    assert(!processor.matchedPhrasesWithoutPositions());
+    
+    // Words must appear in order; slop allows extra words in between
+    assert(matches(processor, "\"rates interest\"").empty());
+    assert(matches(processor, "\"rates interest\"~1") == Documents({"d2"}));
+    assert(matches(processor, "\"interest rates\"~1") == Documents({"d1", "d3"}));
+    
+    // Stopwords are not indexed but keep their place in the phrase
+    assert(matches(processor, "\"bank of england\"") == Documents({"d4"}));
+    assert(matches(processor, "\"bank england\"") == Documents({"d5"}));
+    
+    // Slop is the total number of extra words: d1 has 2, d6 has 4
+    assert(matches(processor, "\"rates inflation\"~1").empty());
+    assert(matches(processor, "\"rates inflation\"~2") == Documents({"d1"}));
+    assert(matches(processor, "\"rates inflation\"~3") == Documents({"d1"}));
+    assert(matches(processor, "\"rates inflation\"~4") == Documents({"d1", "d6"}));
+    
+    // Phrases combine with exclusions and inside boolean expressions
+    assert(matches(processor, "\"interest rates\"~1 -rose") == Documents({"d3"}));
+    assert(matches(processor, "\"interest rates\" OR \"bank england\"") == Documents({"d1", "d5"}));
+    assert(matches(processor, "(\"interest rates\"~1 OR merger) NOT rose") == Documents({"d3", "d5"}));
+}
+
+void test_phrase_without_positions() {
+    IndexHandler index;
+    buildIndex(index, false);
+    StopwordSet stopwords;
+    QueryProcessor processor(index, stopwords);
+    
+    // Matched as a plain AND, which the processor reports instead of printing
+    assert(matches(processor, "\"interest rates\"") == Documents({"d1", "d2", "d3"}));
+    assert(processor.matchedPhrasesWithoutPositions());
+    assert(matches(processor, "\"interest rates\" OR merger") == Documents({"d1", "d2", "d3", "d5"}));
+    assert(processor.matchedPhrasesWithoutPositions());
+    assert(processor.explain("\"interest rates\"").find("no positions") != std::string::npos);
+    
+    matches(processor, "interest rates");
+    assert(!processor.matchedPhrasesWithoutPositions());
+}
+
+// Phrases answered through bigram lists must match the positional path exactly
+void test_bigrams_match_positions() {
+    const std::vector<std::string> vocabulary = {"bank", "of", "england", "rates", "rise", "the", "oil", "price"};
+    std::mt19937 rng(37);
+    std::uniform_int_distribution<size_t> word(0, vocabulary.size() - 1);
+    
+    Articles articles = kArticles;
+    for (size_t n = 0; n < 300; ++n) {
+        std::string content;
+        for (size_t i = 0, length = 3 + rng() % 20; i < length; ++i) {
+            content += i ? " " : "";
+            content += vocabulary[word(rng)];
+        }
+        articles.emplace_back("g" + std::to_string(n), content);
+    }
+    
+    IndexHandler withBigrams;
+    buildIndex(withBigrams, true, articles);
+    IndexHandler positionsOnly;
+    positionsOnly.setBigramLimit(0);
+    buildIndex(positionsOnly, true, articles);
+    
+    StopwordSet stopwords;
+    QueryProcessor bigramProcessor(withBigrams, stopwords);
+    QueryProcessor positionProcessor(positionsOnly, stopwords);
+    assert(bigramProcessor.explain("\"bank england\"").find("bank england") != std::string::npos);
+    
+    std::vector<std::string> queries = {
+        "\"interest rates\"", "\"bank of england\"", "\"bank england\"", "\"oil price\" -rates",
+        "\"interest rates\" OR \"bank england\"",
+    };
+    for (size_t round = 0; round < 200; ++round) {
+        std::string phrase;
+        for (size_t i = 0, length = 2 + round % 3; i < length; ++i) {
+            phrase += i ? " " : "";
+            phrase += vocabulary[word(rng)];
+        }
+        queries.push_back("\"" + phrase + "\"" + (round % 4 == 0 ? "~1" : ""));
+    }
+    
+    for (const auto& query : queries) {
+        auto expected = positionProcessor.processQuery(query);
+        auto actual = bigramProcessor.processQuery(query);
+        assert(actual.size() == expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            assert(actual[i].docID == expected[i].docID);
+            assert(actual[i].score == expected[i].score);
+        }
+    }
+}
+
+int main() {
+    std::cout << "Running phrase query tests..." << std::endl;
+    test_phrases_and_proximity();
+    test_phrase_without_positions();
+    test_bigrams_match_positions();
+    std::cout << "All phrase query tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file test_posting_intersection.cpp
+ * @author <YourName>
+ * @brief Tests galloping and SIMD block intersection (and subtraction) against the std set algorithms
+ * @version 1.0
+ * @date 2024-03-15
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <random>
+#include <vector>
+#include "../include/PostingIntersection.h"
+
+// Ascending sample of about density * universe ordinals
+std::vector<uint32_t> sample(std::mt19937& rng, uint32_t universe, double density) {
+    std::bernoulli_distribution keep(density);
+    std::vector<uint32_t> docs;
+    for (uint32_t doc = 0; doc < universe; ++doc) {
+        if (keep(rng)) {
+            docs.push_back(doc);
+        }
+    }
+    return docs;
+}
+
+std::vector<Posting> toPostings(const std::vector<uint32_t>& docs) {
+    std::vector<Posting> postings;
+    for (uint32_t doc : docs) {
+        postings.push_back({doc, doc % 5 + 1});
+    }
+    return postings;
+}
+
+void test_gallop_to() {
+    std::vector<Posting> postings = toPostings({2, 4, 6, 8, 10, 12, 14, 16, 18, 20});
+    assert(gallopTo(postings, 0, 0) == 0);
+    assert(gallopTo(postings, 0, 2) == 0);
+    assert(gallopTo(postings, 0, 3) == 1);
+    assert(gallopTo(postings, 0, 17) == 8);
+    assert(gallopTo(postings, 3, 4) == 3);
+    assert(gallopTo(postings, 3, 20) == 9);
+    assert(gallopTo(postings, 0, 21) == postings.size());
+    assert(gallopTo(postings, postings.size(), 1) == postings.size());
+}
+
+void test_random_intersections() {
+    std::mt19937 rng(11);
+    const double densities[] = {0.001, 0.01, 0.1, 0.5, 0.9, 1.0};
+    
+    for (int round = 0; round < 300; ++round) {
+        uint32_t universe = 1 + rng() % 5000;
+        std::vector<uint32_t> docs = sample(rng, universe, densities[rng() % 6]);
+        std::vector<uint32_t> other = sample(rng, universe, densities[rng() % 6]);
+        std::vector<Posting> postings = toPostings(other);
+        
+        std::vector<uint32_t> expected;
+        std::set_intersection(docs.begin(), docs.end(), other.begin(), other.end(), std::back_inserter(expected));
+        
+        std::vector<uint32_t> galloped = docs;
+        intersectGalloping(galloped, postings);
+        assert(galloped == expected);
+        
+        std::vector<uint32_t> merged = docs;
+        intersectMerge(merged, postings);
+        assert(merged == expected);
+        
+        std::vector<uint32_t> chosen = docs;
+        intersectPostings(chosen, postings);
+        assert(chosen == expected);
+        
+        std::vector<uint32_t> remaining;
+        std::set_difference(docs.begin(), docs.end(), other.begin(), other.end(), std::back_inserter(remaining));
+        std::vector<uint32_t> subtracted = docs;
+        subtractPostings(subtracted, postings);
+        assert(subtracted == remaining);
+    }
+}
+
+int main() {
+    std::cout << "Running posting intersection tests..." << std::endl;
+    test_gallop_to();
+    test_random_intersections();
+    std::cout << "All posting intersection tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file test_query_cache.cpp
+ * @author <YourName>
+ * @brief Tests for the query result cache and its use by the query processor
+ * @version 1.0
+ * @date 2024-03-15
+ */
+
+#include <iostream>
+#include <cassert>
+#include <string>
+#include "../include/IndexHandler.h"
+#include "../include/QueryCache.h"
+#include "../include/QueryProcessor.h"
+#include "../include/StemCache.h"
+#include "../include/StopwordSet.h"
+
+void test_generations_and_eviction() {
+    QueryCache cache(16 * 1024);
+    QueryCache::RankedDocuments documents = {{2.5, 7}, {1.0, 3}};
+    QueryCache::RankedDocuments found;
+    
+    [[maybe_unused]] bool hit = cache.find("oil", 1, found);
+    assert(!hit);
+    cache.insert("oil", 1, documents);
+    hit = cache.find("oil", 1, found);
+    assert(hit && found == documents);
+    
+    // An entry from another generation is dropped on lookup
+    hit = cache.find("oil", 2, found);
+    assert(!hit);
+    hit = cache.find("oil", 1, found);
+    assert(!hit);
+    
+    [[maybe_unused]] QueryCache::Stats stats = cache.getStats();
+    assert(stats.hits == 1 && stats.misses == 3 && stats.invalidations == 1 && stats.entries == 0);
+    
+    // Far more entries than fit: the byte bound holds and old entries go first
+    for (int i = 0; i < 2000; ++i) {
+        cache.insert("query " + std::to_string(i), 1, documents);
+    }
+    stats = cache.getStats();
+    assert(stats.bytes <= 16 * 1024 && stats.evictions > 0 && stats.entries < 2000);
+    hit = cache.find("query 0", 1, found);
+    assert(!hit);
+    hit = cache.find("query 1999", 1, found);
+    assert(hit);
+}
+
+void test_processor_uses_cache() {
+    IndexHandler index;
+    for (uint32_t n = 0; n < 20; ++n) {
+        uint32_t doc = index.registerDocument("doc-" + std::to_string(n));
+        index.addDocumentMetadata(doc, "title " + std::to_string(n), 0, "source");
+        index.setDocumentLength(doc, 50 + n);
+        for (std::string term : {"oil", "bank"}) {
+            StemCache::shared().stem(term);
+            index.addTerm(term, doc, 1 + n % 3);
+        }
+        if (n % 2 == 0) {
+            index.addOrganization("Goldman Sachs", doc);
+        }
+    }
+    index.buildBigramIndex();
+    
+    StopwordSet stopwords;
+    QueryCache cache;
+    QueryProcessor processor(index, stopwords);
+    processor.setCache(&cache);
+    
+    // Word order and entity spelling do not matter
+    auto first = processor.processQuery("oil bank ORG:goldman_sachs");
+    auto second = processor.processQuery("bank oil ORG:Goldman_Sachs");
+    assert(!first.empty() && first.size() == second.size());
+    for (size_t i = 0; i < first.size(); ++i) {
+        assert(first[i].docID == second[i].docID && first[i].score == second[i].score);
+        assert(first[i].title == second[i].title);
+    }
+    assert(cache.getStats().hits == 1);
+    
+    // A bigram build with nothing to rebuild leaves the index, and the cache, as they were
+    index.buildBigramIndex();
+    processor.processQuery("oil bank ORG:goldman_sachs");
+    assert(cache.getStats().hits == 2);
+    
+    // Any change to the index makes earlier rankings stale
+    uint32_t doc = index.registerDocument("doc-new");
+    index.setDocumentLength(doc, 10);
+    auto third = processor.processQuery("bank oil ORG:Goldman_Sachs");
+    [[maybe_unused]] QueryCache::Stats stats = cache.getStats();
+    assert(stats.hits == 2 && stats.invalidations == 1);
+    assert(third.size() == first.size());
+}
+
+int main() {
+    std::cout << "Running query cache tests..." << std::endl;
+    test_generations_and_eviction();
+    test_processor_uses_cache();
+    std::cout << "All query cache tests passed!" << std::endl;
+    return 0;
+}
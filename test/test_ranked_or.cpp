@@ -0,0 +1,130 @@
+/**
+ * @file test_ranked_or.cpp
+ * @author <YourName>
+ * @brief Tests that pruned ranked OR retrieval returns the exhaustive top results
+ * @version 1.0
+ * @date 2024-03-15
+ */
+
+#include <iostream>
+#include <cassert>
+#include <random>
+#include <string>
+#include <vector>
+#include "../include/IndexHandler.h"
+#include "../include/QueryProcessor.h"
+#include "../include/StemCache.h"
+#include "../include/StopwordSet.h"
+
+const std::vector<std::string> kWords = {
+    "market", "stock", "bank", "oil", "price", "trade", "rate", "fund", "bond", "yield",
+    "growth", "merger", "tariff", "crude", "dollar", "euro", "profit", "loss", "debt", "gold",
+};
+
+// Synthetic collection with skewed term frequencies and document lengths
+void buildIndex(IndexHandler& index, std::mt19937& rng) {
+    std::uniform_int_distribution<uint32_t> length(20, 600);
+    std::geometric_distribution<uint32_t> extraOccurrences(0.4);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    
+    for (uint32_t n = 0; n < 4000; ++n) {
+        uint32_t doc = index.registerDocument("doc-" + std::to_string(n));
+        index.addDocumentMetadata(doc, "title", 0, "source");
+        index.setDocumentLength(doc, length(rng));
+        for (size_t w = 0; w < kWords.size(); ++w) {
+            if (unit(rng) < 0.6 / static_cast<double>(w + 1)) {
+                std::string term = kWords[w];
+                StemCache::shared().stem(term);
+                index.addTerm(term, doc, 1 + extraOccurrences(rng));
+            }
+        }
+        if (n % 11 == 0) {
+            index.addOrganization("Goldman Sachs", doc);
+        }
+    }
+    index.deleteDocuments({3, 500, 1234, 3999});
+    index.buildScoreBounds();
+}
+
+void test_pruned_matches_exhaustive() {
+    std::mt19937 rng(46);
+    IndexHandler index;
+    buildIndex(index, rng);
+    
+    StopwordSet stopwords;
+    QueryProcessor pruned(index, stopwords);
+    QueryProcessor exhaustive(index, stopwords);
+    exhaustive.setPruning(false);
+    
+    std::uniform_int_distribution<size_t> word(0, kWords.size() - 1);
+    for (int round = 0; round < 300; ++round) {
+        std::string query = kWords[word(rng)];
+        size_t extra = 1 + rng() % 5;
+        for (size_t i = 0; i < extra; ++i) {
+            query += " OR " + kWords[word(rng)];
+        }
+        if (round % 5 == 0) {
+            query += " OR ORG:Goldman_Sachs";
+        }
+        if (round % 7 == 0) {
+            query = "(" + query + ") -" + kWords[word(rng)];
+        }
+        
+        auto expected = exhaustive.processQuery(query);
+        auto actual = pruned.processQuery(query);
+        assert(actual.size() == expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            assert(actual[i].docID == expected[i].docID);
+            assert(actual[i].score == expected[i].score);
+        }
+    }
+    
+    // Any of the words qualifies a document, so common words fill the page
+    assert(pruned.processQuery("market OR gold").size() == QueryProcessor::kResultLimit);
+    assert(pruned.processQuery("market gold").size() <= QueryProcessor::kResultLimit);
+}
+
+// Tombstones that outnumber a term's live documents must not change the results
+void test_deleted_documents_dominate() {
+    IndexHandler index;
+    std::vector<uint32_t> deleted;
+    for (uint32_t n = 0; n < 200; ++n) {
+        uint32_t doc = index.registerDocument("doc-" + std::to_string(n));
+        index.setDocumentLength(doc, 50 + (n % 7) * 10);
+        if (n < 120) {
+            index.addTerm("market", doc, 1 + n % 4);
+        }
+        if (n % 3 == 0) {
+            index.addTerm("stock", doc, 1 + n % 2);
+        }
+        if (n < 110) {
+            deleted.push_back(doc);
+        }
+    }
+    index.deleteDocuments(deleted);
+    index.buildScoreBounds();
+    
+    StopwordSet stopwords;
+    QueryProcessor pruned(index, stopwords);
+    QueryProcessor exhaustive(index, stopwords);
+    exhaustive.setPruning(false);
+    for (const std::string query : {"market OR stock", "stock OR market", "market"}) {
+        auto expected = exhaustive.processQuery(query);
+        auto actual = pruned.processQuery(query);
+        assert(!expected.empty());
+        assert(actual.size() == expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            assert(actual[i].docID == expected[i].docID);
+            assert(actual[i].score == expected[i].score);
+            assert(expected[i].score > 0.0);
+        }
+    }
+}
+
+int main() {
+    std::cout << "Running ranked OR tests..." << std::endl;
+    test_pruned_matches_exhaustive();
+    test_deleted_documents_dominate();
+    std::cout << "All ranked OR tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file test_simhash.cpp
+ * @author <YourName>
+ * @brief Tests for SimHash fingerprints and the banded near-duplicate index
+ * @version 1.0
+ * @date 2024-03-15
+ */
+
+#include <iostream>
+#include <cassert>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../include/SimHash.h"
+
+// Fingerprint of a text from its distinct words and distinct pairs of consecutive words
+uint64_t fingerprint(const std::string& text) {
+    std::istringstream words(text);
+    std::set<uint64_t> features;
+    std::string word;
+    uint64_t previous = 0;
+    for (bool first = true; words >> word; first = false) {
+        uint64_t hash = SimHash::hash(word);
+        features.insert(hash);
+        if (!first) {
+            features.insert(SimHash::combine(previous, hash));
+        }
+        previous = hash;
+    }
+    
+    SimHash simhash;
+    for (uint64_t feature : features) {
+        simhash.add(feature);
+    }
+    return simhash.fingerprint();
+}
+
+void test_fingerprints() {
+    std::string story;
+    for (int i = 0; i < 60; ++i) {
+        story += "federal reserve officials signaled rates would rise " + std::to_string(i) + " times ";
+    }
+    std::string edited = story;
+    edited.replace(edited.find("signaled"), 8, "hinted");
+    std::string other;
+    for (int i = 0; i < 60; ++i) {
+        other += "oil prices fell as supply concerns eased in week " + std::to_string(i) + " ";
+    }
+    
+    assert(SimHash().fingerprint() == 0);
+    assert(fingerprint(story) == fingerprint(story));
+    assert(SimHash::distance(fingerprint(story), fingerprint(edited)) <= SimHashIndex::kMaxDistance);
+    assert(SimHash::distance(fingerprint(story), fingerprint(other)) > 10);
+}
+
+void test_index() {
+    uint64_t base = 0x0123456789ABCDEFULL;
+    SimHashIndex index;
+    assert(index.find(base) == SimHashIndex::kNotFound);
+    
+    index.insert(0, 0xFFFF0000FFFF0000ULL);
+    index.insert(1, base);
+    index.insert(2, base ^ 0x1);
+    index.insert(3, 0);
+    
+    // Up to kMaxDistance flipped bits are found, even when they hit different bands
+    assert(index.find(base) == 1);
+    assert(index.find(base ^ 0x1) == 1);
+    assert(index.find(base ^ 0x0000100200400800ULL ^ 0x4) == 1);
+    assert(index.find(base ^ 0x0080200400801002ULL) == SimHashIndex::kNotFound);
+    assert(index.find(0) == SimHashIndex::kNotFound);
+    assert(index.fingerprints().size() == 3);
+    
+    index.clear();
+    assert(index.find(base) == SimHashIndex::kNotFound);
+}
+
+int main() {
+    std::cout << "Running SimHash tests..." << std::endl;
+    test_fingerprints();
+    test_index();
+    std::cout << "All SimHash tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file test_stem_cache.cpp
+ * @author <YourName>
+ * @brief Tests for the bounded, sharded stem cache
+ * @version 1.0
+ * @date 2024-03-15
+ */
+
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/StemCache.h"
+#include "../thirdparty/porter2_stemmer/thirdparty/porter2_stemmer/porter2_stemmer.h"
+
+// Distinct inflected words, so stemming actually changes most of them
+std::vector<std::string> makeWords(size_t count) {
+    const std::vector<std::string> suffixes = {"ing", "ed", "s", "ation", "ly", "ness"};
+    std::vector<std::string> words;
+    for (size_t i = 0; i < count; ++i) {
+        std::string word;
+        for (size_t n = i + 1; n > 0; n /= 26) {
+            word.push_back(static_cast<char>('a' + n % 26));
+        }
+        words.push_back("trad" + word + suffixes[i % suffixes.size()]);
+    }
+    return words;
+}
+
+std::string porterStem(std::string word) {
+    Porter2Stemmer::stem(word);
+    return word;
+}
+
+void test_bounded_generations() {
+    StemCache cache(64);
+    std::string word = "running";
+    cache.stem(word);
+    assert(word == porterStem("running"));
+    word = "running";
+    cache.stem(word);
+    assert(word == porterStem("running"));
+    StemCache::Stats stats = cache.getStats();
+    assert(stats.hits == 1 && stats.misses == 1 && stats.entries == 1);
+    
+    // Many other words retire both generations of every shard, "running" included
+    for (std::string other : makeWords(2000)) {
+        cache.stem(other);
+    }
+    stats = cache.getStats();
+    assert(stats.entries <= 64);
+    assert(stats.misses == 2001);
+    
+    word = "running";
+    cache.stem(word);
+    assert(word == porterStem("running"));
+    assert(cache.getStats().misses == 2002);
+}
+
+void test_concurrent_stemming() {
+    StemCache cache(1 << 12);
+    const std::vector<std::string> words = makeWords(500);
+    std::vector<std::string> expected;
+    for (const auto& word : words) {
+        expected.push_back(porterStem(word));
+    }
+    
+    // Each thread stems the whole vocabulary several times, in its own order
+    const size_t threadCount = 4, passes = 5;
+    std::atomic<bool> agreed{true};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t pass = 0; pass < passes; ++pass) {
+                for (size_t i = 0; i < words.size(); ++i) {
+                    size_t k = (i * (2 * t + 1) + pass) % words.size();
+                    std::string word = words[k];
+                    cache.stem(word);
+                    if (word != expected[k]) {
+                        agreed = false;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    assert(agreed);
+    
+    // Every call is counted once; a word can miss at most once per thread
+    [[maybe_unused]] StemCache::Stats stats = cache.getStats();
+    assert(stats.hits + stats.misses == threadCount * passes * words.size());
+    assert(stats.misses >= words.size() && stats.misses <= threadCount * words.size());
+    assert(stats.entries == words.size());
+    assert(stats.hitRate() > 0.5 && stats.hitRate() < 1.0);
+    
+    // Each thread times its first call (word 0, a miss for whichever thread gets
+    // there first) and one call in 64 after that
+    assert(stats.avgMissNanos > 0.0);
+    assert(stats.avgHitNanos > 0.0);
+}
+
+int main() {
+    std::cout << "Running stem cache tests..." << std::endl;
+    test_bounded_generations();
+    test_concurrent_stemming();
+    std::cout << "All stem cache tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file test_tokenizer.cpp
+ * @author <YourName>
+ * @brief Tests for the SIMD tokenizer against the original istringstream pipeline
+ * @version 1.0
+ * @date 2024-03-15
+ */
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <cassert>
+#include <cctype>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "../include/Tokenizer.h"
+
+// The tokenization processContent used before the tokenizer existed
+std::vector<std::string> referenceTokens(const std::string& text) {
+    std::istringstream iss(text);
+    std::string token;
+    std::vector<std::string> tokens;
+    
+    while (iss >> token) {
+        std::transform(token.begin(), token.end(), token.begin(),
+                      [](unsigned char c) { return std::tolower(c); });
+        token.erase(std::remove_if(token.begin(), token.end(), 
+                                 [](unsigned char c) { return std::ispunct(c); }),
+                   token.end());
+        if (!token.empty()) {
+            tokens.push_back(token);
+        }
+    }
+    return tokens;
+}
+
+void expectSameTokens(Tokenizer& tokenizer, const std::string& text) {
+    const auto& tokens = tokenizer.tokenize(text);
+    auto expected = referenceTokens(text);
+    
+    assert(tokens.size() == expected.size());
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        assert(tokens[i] == expected[i]);
+    }
+}
+
+void test_basic_tokens() {
+    Tokenizer tokenizer;
+    
+    const auto& tokens = tokenizer.tokenize("The Fed's RATE-hike, (again)!  U.S. stocks\tfell 2.5%");
+    std::vector<std::string> expected = {"the", "feds", "ratehike", "again", "us", "stocks", "fell", "25"};
+    assert(tokens.size() == expected.size());
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        assert(tokens[i] == expected[i]);
+    }
+    
+    // Punctuation-only tokens vanish
+    expectSameTokens(tokenizer, "-- ... !!! cafe Societe 5bn");
+    expectSameTokens(tokenizer, "");
+    expectSameTokens(tokenizer, "   \n\t ");
+    
+    assert(tokenizer.normalize("Earnings,") == "earnings");
+    assert(tokenizer.normalize("?!") == "");
+}
+
+void test_unicode() {
+    Tokenizer tokenizer;
+    
+    // Case folding, Unicode punctuation and spaces, with the accented words at
+    // every offset so they are split across SIMD blocks
+    std::string upper = "SOCI\xC3\x89T\xC3\x89 G\xC3\x89N\xC3\x89RALE\xE2\x80\x99S \xE2\x82\xAC" "5BN"
+                        "\xC2\xA0\xCE\x91\xCE\x98\xCE\x97\xCE\x9D\xCE\x91 \xD0\x9C\xD0\x9E\xD0\xA1\xD0\x9A\xD0\x92\xD0\x90";
+    std::vector<std::string> expected = {"soci\xC3\xA9t\xC3\xA9", "g\xC3\xA9n\xC3\xA9rales", "5bn",
+                                         "\xCE\xB1\xCE\xB8\xCE\xB7\xCE\xBD\xCE\xB1",
+                                         "\xD0\xBC\xD0\xBE\xD1\x81\xD0\xBA\xD0\xB2\xD0\xB0"};
+    for (size_t padding = 1; padding <= 40; ++padding) {
+        [[maybe_unused]] const auto& tokens = tokenizer.tokenize(std::string(padding, 'x') + " " + upper);
+        assert(tokens.size() == expected.size() + 1);
+        for (size_t i = 0; i < expected.size(); ++i) {
+            assert(tokens[i + 1] == expected[i]);
+        }
+    }
+    
+    // Malformed bytes (stray continuation, overlong, surrogate, truncated) are skipped
+    assert(tokenizer.normalize("a\x80" "b\xC0\xAF" "c\xED\xA0\x80" "d\xE2\x82") == "abcd");
+    assert(tokenizer.normalize("Stra\xC3\x9F" "e") == tokenizer.normalize("STRA\xE1\xBA\x9E" "E"));
+}
+
+// Whether a string is well-formed UTF-8
+bool validUTF8(std::string_view text) {
+    for (size_t i = 0; i < text.size(); ) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        size_t length = c < 0x80 ? 1 : c >= 0xC2 && c <= 0xDF ? 2 : c >= 0xE0 && c <= 0xEF ? 3 : c >= 0xF0 && c <= 0xF4 ? 4 : 0;
+        if (length == 0 || i + length > text.size()) {
+            return false;
+        }
+        for (size_t k = 1; k < length; ++k) {
+            if ((static_cast<unsigned char>(text[i + k]) & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        i += length;
+    }
+    return true;
+}
+
+void test_random_bytes() {
+    // Arbitrary bytes always give valid UTF-8 tokens, and the result does not
+    // depend on where the SIMD blocks start
+    const std::string alphabet = "aZ0 .\x80\xBF\xC3\xA9\x89\xE2\x82\xAC\xF0\x9F\xD0\x9C\xC2\xA0";
+    std::mt19937 rng(7);
+    Tokenizer tokenizer;
+    
+    for (int round = 0; round < 2000; ++round) {
+        std::string text(rng() % 120, ' ');
+        for (auto& c : text) {
+            c = alphabet[rng() % alphabet.size()];
+        }
+        std::vector<std::string> expected;
+        for (const auto& token : tokenizer.tokenize(" " + text)) {
+            assert(validUTF8(token));
+            expected.emplace_back(token);
+        }
+        [[maybe_unused]] const auto& shifted = tokenizer.tokenize(std::string(rng() % 32 + 1, ' ') + text);
+        assert(shifted.size() == expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            assert(shifted[i] == expected[i]);
+        }
+    }
+}
+
+void test_random_text() {
+    // Long random inputs cross block boundaries at every offset
+    const std::string alphabet = "aZm09 .,'\"-!\t\n\r\x0b\x0c{}~`@[";
+    std::mt19937 rng(42);
+    Tokenizer tokenizer;
+    
+    for (int round = 0; round < 2000; ++round) {
+        std::string text(rng() % 200, ' ');
+        for (auto& c : text) {
+            c = alphabet[rng() % alphabet.size()];
+        }
+        expectSameTokens(tokenizer, text);
+    }
+}
+
+int main() {
+    std::cout << "Running tokenizer tests..." << std::endl;
+    test_basic_tokens();
+    test_random_text();
+    test_unicode();
+    test_random_bytes();
+    std::cout << "All tokenizer tests passed!" << std::endl;
+    return 0;
+}